@@ -0,0 +1,669 @@
+/*
+  ==============================================================================
+
+    DelayBenchmark.cpp
+    Created: 17 Oct 2026 1:48:09pm
+    Author:  Chris
+
+    Headless micro-benchmark for the Delay engine. Build it as a JUCE console
+    application containing this file and Source/Processing (juce_core,
+    juce_audio_basics and juce_dsp only - no editor or plugin wrapper).
+
+    Usage: DelayBenchmark [--seconds <audio seconds per case>] [--quick]
+                          [--write-baseline <file> | --check-baseline <file>]
+                          [--threshold <allowed slowdown, default 0.15>]
+           DelayBenchmark --write-golden <dir> | --check-golden <dir>
+                          [--tolerance <max abs error, default 3e-5>]
+
+    Delay bank cases run many mono lines through one DelayBank, once with
+    its groups spread over every core and once inline, and report time per
+    line-sample like the other cases.
+    Double cases run Delay<double> on stereo, as a 64-bit host bus would.
+    Golden renders are checked at both precisions against the same float
+    reference.
+
+    Golden cases render each parameter state, then the plugin's own setup
+    (Lagrange, long-delay mode, medium quality), each interpolator, the
+    lower quality tiers, a bypass, a sleep and wake, and a snapshot restored
+    into a fresh delay mid-render.
+
+    Prints one JSON object with a result per case on stdout. The baseline
+    and golden modes exit with 1 when a case is slower than the stored
+    baseline by more than the threshold, or when a render drifts from its
+    stored reference by more than the tolerance. Each case is timed as the
+    fastest of BENCHMARK_PASSES passes.
+
+    The references are in Benchmarks/Golden; check them with
+    --check-golden Benchmarks/Golden. Benchmarks/Baseline.txt was written
+    with --quick --seconds 10, and timings only compare on the machine that
+    wrote them, so write a baseline of your own before gating on one.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../Source/Processing/Delay.h"
+#include "../Source/Processing/DelayBank.h"
+
+#include <fstream>
+#include <limits>
+#include <map>
+
+#if JUCE_INTEL
+ #include <x86intrin.h>
+#endif
+#define BENCHMARK_PASSES 5
+
+namespace {
+
+enum class ParameterState {
+    staticParameters,
+    automated,
+    modulated,
+    highFeedback,
+    multiTap,
+    network,
+    shapedFeedback,
+    softOutput,
+    jumpAutomated
+};
+
+const char* getName(ParameterState state){
+    switch (state){
+        case ParameterState::staticParameters: return "static";
+        case ParameterState::automated:        return "automated";
+        case ParameterState::modulated:        return "modulated";
+        case ParameterState::highFeedback:     return "highFeedback";
+        case ParameterState::multiTap:         return "multiTap";
+        case ParameterState::network:          return "network";
+        case ParameterState::shapedFeedback:   return "shapedFeedback";
+        case ParameterState::softOutput:       return "softOutput";
+        case ParameterState::jumpAutomated:    return "jumpAutomated";
+    }
+    return "";
+}
+
+const char* getName(DelayBufferLayout layout){
+    return layout == DelayBufferLayout::interleaved ? "interleaved" : "planar";
+}
+
+juce::uint64 readCycleCounter(){
+   #if JUCE_INTEL
+    return (juce::uint64) __rdtsc();
+   #else
+    return 0;
+   #endif
+}
+
+struct BenchmarkCase {
+    double sampleRate;
+    int blockSize;
+    int numChannels;
+    ParameterState state;
+    DelayBufferLayout layout;
+    bool doublePrecision = false;
+};
+
+struct BenchmarkResult {
+    double nanosecondsPerSample;
+    double realtimeFactor;
+    double cyclesPerFrame;
+};
+
+template <typename SampleType>
+void applyParameters(Delay<SampleType>& delay, ParameterState state){
+    delay.setDelayLength(350);
+    delay.setMix(0.5f);
+    const bool isHot = state == ParameterState::highFeedback || state == ParameterState::shapedFeedback
+                       || state == ParameterState::softOutput;
+    delay.setFeedback(isHot ? 0.95f : 0.4f);
+    delay.setRate(state == ParameterState::modulated ? 2.0f : 0.01f);
+    delay.setDepth(state == ParameterState::modulated ? 5 : 0);
+    
+    // A dotted-eighth pattern at 120 bpm, panned across the field
+    const int numTaps = state == ParameterState::multiTap ? 4 : 0;
+    delay.setNumTaps(numTaps);
+    for (int tap = 0; tap < numTaps; ++tap){
+        delay.setTap(tap, 187.5f * (float) (tap + 1), 1.0f - 0.2f * (float) tap, tap % 2 == 0 ? -0.7f : 0.7f, 0.3f);
+    }
+    
+    delay.setNetworkSize(state == ParameterState::network ? 8 : 0);
+    
+    // Dark, thin, driven repeats
+    const bool isShaped = state == ParameterState::shapedFeedback;
+    delay.setHighCut(isShaped ? 3000.0f : FEEDBACK_HIGH_CUT_OFF_HZ);
+    delay.setLowCut(isShaped ? 200.0f : FEEDBACK_LOW_CUT_OFF_HZ);
+    delay.setSaturation(isShaped ? 0.6f : 0.0f);
+    
+    // A hot loop driven into the anti-aliased curve
+    delay.setOutputShape(state == ParameterState::softOutput ? OutputShape::polynomialTanh : OutputShape::clamp);
+    
+    // Automation again, with the head jumping rather than gliding to each new time
+    delay.setDelayTimeMode(state == ParameterState::jumpAutomated ? DelayTimeMode::jump : DelayTimeMode::tape);
+}
+
+bool isAutomated(ParameterState state){
+    return state == ParameterState::automated || state == ParameterState::jumpAutomated;
+}
+
+// Automation moves every parameter on every block, so the smoothers never settle
+template <typename SampleType>
+void automateParameters(Delay<SampleType>& delay, juce::Random& random){
+    delay.setDelayLength(1 + random.nextInt(999));
+    delay.setMix(random.nextFloat());
+    delay.setFeedback(random.nextFloat() * 0.95f);
+}
+
+// Float keys are unprefixed, so baselines written before double cases still match
+std::string getCaseKey(const BenchmarkCase& benchmarkCase){
+    return std::string(benchmarkCase.doublePrecision ? "double/" : "") + getName(benchmarkCase.layout) + "/" + getName(benchmarkCase.state)
+         + "/" + std::to_string(benchmarkCase.numChannels) + "ch/" + std::to_string((int) benchmarkCase.sampleRate)
+         + "/" + std::to_string(benchmarkCase.blockSize);
+}
+
+template <typename SampleType>
+void fillNoise(juce::AudioBuffer<SampleType>& buffer, juce::Random& random){
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel){
+        SampleType* channelData = buffer.getWritePointer(channel);
+        for (int sample = 0; sample < buffer.getNumSamples(); ++sample){
+            channelData[sample] = (SampleType) (random.nextFloat() * 0.5f - 0.25f);
+        }
+    }
+}
+
+struct PassTiming {
+    double seconds;
+    juce::uint64 cycles;
+};
+
+// Times the blocks in BENCHMARK_PASSES equal passes and scales the fastest
+// up to the whole run, so a pass the scheduler interrupted doesn't count
+template <typename ProcessOneBlock>
+PassTiming timeFastestPass(ProcessOneBlock&& processOneBlock, int numBlocks){
+    const int numPasses = juce::jmin(BENCHMARK_PASSES, numBlocks);
+    const int blocksPerPass = numBlocks / numPasses;
+    
+    PassTiming fastest { std::numeric_limits<double>::max(), 0 };
+    for (int pass = 0; pass < numPasses; ++pass){
+        const auto startTicks = juce::Time::getHighResolutionTicks();
+        const auto startCycles = readCycleCounter();
+        
+        for (int i = 0; i < blocksPerPass; ++i){
+            processOneBlock();
+        }
+        
+        const auto endCycles = readCycleCounter();
+        const auto endTicks = juce::Time::getHighResolutionTicks();
+        
+        const double seconds = juce::Time::highResolutionTicksToSeconds(endTicks - startTicks);
+        if (seconds < fastest.seconds){
+            fastest = { seconds, endCycles - startCycles };
+        }
+    }
+    
+    const double scale = (double) numBlocks / (double) blocksPerPass;
+    return { fastest.seconds * scale, (juce::uint64) ((double) fastest.cycles * scale) };
+}
+
+template <typename SampleType>
+BenchmarkResult runCase(const BenchmarkCase& benchmarkCase, double secondsPerCase){
+    Delay<SampleType> delay;
+    delay.prepareToPlay(benchmarkCase.sampleRate, benchmarkCase.blockSize, benchmarkCase.numChannels, benchmarkCase.layout);
+    applyParameters(delay, benchmarkCase.state);
+    
+    juce::Random random (0x5eed);
+    
+    // Precomputed input keeps the signal generator out of the timed loop
+    juce::AudioBuffer<SampleType> input (benchmarkCase.numChannels, benchmarkCase.blockSize);
+    juce::AudioBuffer<SampleType> buffer (benchmarkCase.numChannels, benchmarkCase.blockSize);
+    fillNoise(input, random);
+    
+    const int numBlocks = juce::jmax(1, (int) (secondsPerCase * benchmarkCase.sampleRate / benchmarkCase.blockSize));
+    const int numWarmupBlocks = juce::jmax(1, numBlocks / 10);
+    
+    auto processOneBlock = [&]{
+        for (int channel = 0; channel < benchmarkCase.numChannels; ++channel){
+            buffer.copyFrom(channel, 0, input, channel, 0, benchmarkCase.blockSize);
+        }
+        if (isAutomated(benchmarkCase.state)){
+            automateParameters(delay, random);
+        }
+        juce::dsp::AudioBlock<SampleType> block (buffer);
+        delay.process(juce::dsp::ProcessContextReplacing<SampleType> (block));
+    };
+    
+    juce::ScopedNoDenormals noDenormals;
+    
+    for (int i = 0; i < numWarmupBlocks; ++i){
+        processOneBlock();
+    }
+    
+    const auto timing = timeFastestPass(processOneBlock, numBlocks);
+    const double elapsedSeconds = timing.seconds;
+    const double numFrames = (double) numBlocks * benchmarkCase.blockSize;
+    
+    BenchmarkResult result;
+    result.nanosecondsPerSample = elapsedSeconds * 1.0e9 / (numFrames * benchmarkCase.numChannels);
+    result.realtimeFactor = (numFrames / benchmarkCase.sampleRate) / elapsedSeconds;
+    result.cyclesPerFrame = (double) timing.cycles / numFrames;
+    return result;
+}
+
+// Each line gets its own time and feedback, as separate channel strips would.
+// numWorkers is passed through, so 0 runs every group inline.
+BenchmarkResult runBankCase(double sampleRate, int blockSize, int numLines, int numWorkers, double secondsPerCase){
+    DelayBank<float> bank;
+    bank.prepareToPlay(sampleRate, blockSize, numLines, DelayInterpolation::linear, numWorkers);
+    for (int line = 0; line < numLines; ++line){
+        bank.setDelayLength(line, 50 + (line * 37) % 900);
+        bank.setFeedback(line, 0.2f + 0.5f * (float) (line % 4) / 4.0f);
+        bank.setMix(line, 0.5f);
+    }
+    
+    juce::Random random (0x5eed);
+    juce::AudioBuffer<float> input (numLines, blockSize);
+    juce::AudioBuffer<float> buffer (numLines, blockSize);
+    fillNoise(input, random);
+    
+    const int numBlocks = juce::jmax(1, (int) (secondsPerCase * sampleRate / blockSize));
+    
+    auto processOneBlock = [&]{
+        for (int line = 0; line < numLines; ++line){
+            buffer.copyFrom(line, 0, input, line, 0, blockSize);
+        }
+        juce::dsp::AudioBlock<float> block (buffer);
+        bank.process(juce::dsp::ProcessContextReplacing<float> (block));
+    };
+    
+    juce::ScopedNoDenormals noDenormals;
+    
+    for (int i = 0; i < juce::jmax(1, numBlocks / 10); ++i){
+        processOneBlock();
+    }
+    
+    const auto timing = timeFastestPass(processOneBlock, numBlocks);
+    const double elapsedSeconds = timing.seconds;
+    const double numFrames = (double) numBlocks * blockSize;
+    
+    BenchmarkResult result;
+    result.nanosecondsPerSample = elapsedSeconds * 1.0e9 / (numFrames * numLines);
+    result.realtimeFactor = (numFrames / sampleRate) / elapsedSeconds;
+    result.cyclesPerFrame = (double) timing.cycles / numFrames;
+    return result;
+}
+    
+
+//==============================================================================
+// Golden renders
+//==============================================================================
+enum class TestSignal {
+    impulse,
+    sineSweep,
+    noise
+};
+
+const char* getName(TestSignal signal){
+    switch (signal){
+        case TestSignal::impulse:   return "impulse";
+        case TestSignal::sineSweep: return "sweep";
+        case TestSignal::noise:     return "noise";
+    }
+    return "";
+}
+
+constexpr double goldenSampleRate = 48000.0;
+constexpr int goldenBlockSize = 256;
+constexpr int goldenNumChannels = 2;
+constexpr int goldenNumSamples = 96000;
+
+// What happens partway through a golden render
+enum class GoldenEvent {
+    none,
+    bypass,    // bypassed mid-signal and back once the tail has gone
+    sleep,     // no feedback, and a second burst after the delay has fallen asleep
+    snapshot   // snapshotted halfway and carried on by a fresh delay restored from it
+};
+
+// A parameter state and the setup it is rendered with. The plain cases
+// have no name, so their files keep the names they had before scenarios.
+struct GoldenScenario {
+    const char* name;
+    ParameterState state;
+    DelayInterpolation interpolation = DelayInterpolation::linear;
+    DelayQuality quality = DelayQuality::high;
+    bool longDelayMode = false;
+    GoldenEvent event = GoldenEvent::none;
+};
+
+std::vector<GoldenScenario> getGoldenScenarios(){
+    std::vector<GoldenScenario> scenarios;
+    for (auto state : { ParameterState::staticParameters, ParameterState::automated,
+                        ParameterState::modulated, ParameterState::highFeedback,
+                        ParameterState::multiTap, ParameterState::network,
+                        ParameterState::shapedFeedback, ParameterState::softOutput,
+                        ParameterState::jumpAutomated }){
+        scenarios.push_back({ "", state });
+    }
+    
+    // As the plugin runs it: Lagrange, long-delay mode, starting at medium
+    scenarios.push_back({ "plugin", ParameterState::automated, DelayInterpolation::lagrange3, DelayQuality::medium, true });
+    
+    // Modulation keeps the reads fractional, which is where the interpolators differ
+    scenarios.push_back({ "cubicHermite", ParameterState::modulated, DelayInterpolation::cubicHermite });
+    scenarios.push_back({ "lagrange3", ParameterState::modulated, DelayInterpolation::lagrange3 });
+    scenarios.push_back({ "thiran", ParameterState::modulated, DelayInterpolation::thiran });
+    scenarios.push_back({ "mediumQuality", ParameterState::modulated, DelayInterpolation::lagrange3, DelayQuality::medium });
+    scenarios.push_back({ "lowQuality", ParameterState::modulated, DelayInterpolation::lagrange3, DelayQuality::low });
+    
+    scenarios.push_back({ "bypass", ParameterState::highFeedback, DelayInterpolation::linear, DelayQuality::high, false, GoldenEvent::bypass });
+    scenarios.push_back({ "sleep", ParameterState::staticParameters, DelayInterpolation::linear, DelayQuality::high, false, GoldenEvent::sleep });
+    scenarios.push_back({ "snapshot", ParameterState::modulated, DelayInterpolation::thiran, DelayQuality::high, true, GoldenEvent::snapshot });
+    return scenarios;
+}
+
+void fillTestSignal(juce::AudioBuffer<float>& buffer, TestSignal signal){
+    buffer.clear();
+    juce::Random random (0x601d);
+    
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel){
+        float* channelData = buffer.getWritePointer(channel);
+        
+        // Only the first half second carries signal, the rest is the echo tail
+        const int numActive = buffer.getNumSamples() / 4;
+        
+        for (int sample = 0; sample < numActive; ++sample){
+            switch (signal){
+                case TestSignal::impulse:
+                    channelData[sample] = sample == 0 ? 1.0f : 0.0f;
+                    break;
+                case TestSignal::sineSweep: {
+                    // Exponential 20 Hz - 20 kHz sweep
+                    const double duration = numActive / goldenSampleRate;
+                    const double rate = std::log(20000.0 / 20.0);
+                    const double t = sample / goldenSampleRate;
+                    const double phase = juce::MathConstants<double>::twoPi * 20.0 * duration / rate * (std::exp(t * rate / duration) - 1.0);
+                    channelData[sample] = 0.5f * (float) std::sin(phase);
+                    break;
+                }
+                case TestSignal::noise:
+                    channelData[sample] = random.nextFloat() - 0.5f;
+                    break;
+            }
+        }
+    }
+}
+
+// Renders offline, so a lazy memory never waits on its allocator and the
+// render doesn't depend on timing
+template <typename SampleType>
+void prepareGoldenDelay(Delay<SampleType>& delay, const GoldenScenario& scenario, DelayBufferLayout layout){
+    delay.setLongDelayMode(scenario.longDelayMode);
+    delay.prepareToPlay(goldenSampleRate, goldenBlockSize, goldenNumChannels, layout, scenario.interpolation);
+    delay.setNonRealtime(true);
+    applyParameters(delay, scenario.state);
+    delay.setQuality(scenario.quality);
+    if (scenario.event == GoldenEvent::sleep){
+        delay.setFeedback(0.0f);
+    }
+}
+
+// Renders the signal through the delay with the scenario's setup, one block at
+// a time. The test signal is generated in float, so both precisions see the same input.
+template <typename SampleType>
+std::vector<float> renderGolden(TestSignal signal, const GoldenScenario& scenario, DelayBufferLayout layout){
+    auto delay = std::make_unique<Delay<SampleType>>();
+    prepareGoldenDelay(*delay, scenario, layout);
+    
+    juce::AudioBuffer<float> testSignal (goldenNumChannels, goldenNumSamples);
+    fillTestSignal(testSignal, signal);
+    
+    // The second burst starts well after the first one's echo has died away
+    const int secondBurst = goldenNumSamples * 3 / 4;
+    if (scenario.event == GoldenEvent::sleep){
+        for (int channel = 0; channel < goldenNumChannels; ++channel){
+            testSignal.copyFrom(channel, secondBurst, testSignal, channel, 0, goldenNumSamples / 8);
+        }
+    }
+    
+    juce::AudioBuffer<SampleType> buffer (goldenNumChannels, goldenNumSamples);
+    for (int channel = 0; channel < goldenNumChannels; ++channel){
+        for (int sample = 0; sample < goldenNumSamples; ++sample){
+            buffer.setSample(channel, sample, (SampleType) testSignal.getSample(channel, sample));
+        }
+    }
+    
+    juce::Random random (0xa070);
+    for (int start = 0; start < goldenNumSamples; start += goldenBlockSize){
+        if (scenario.event == GoldenEvent::bypass){
+            delay->setBypassed(start >= goldenNumSamples / 8 && start < goldenNumSamples / 2);
+        }
+        if (scenario.event == GoldenEvent::snapshot && start == goldenNumSamples / 2){
+            delay->requestSnapshot();
+            delay->finishSnapshot();
+            juce::MemoryBlock snapshot;
+            {
+                juce::MemoryOutputStream stream (snapshot, false);
+                delay->writeSnapshot(stream);
+            }
+            
+            delay = std::make_unique<Delay<SampleType>>();
+            prepareGoldenDelay(*delay, scenario, layout);
+            juce::MemoryInputStream stream (snapshot, false);
+            delay->readSnapshot(stream);
+        }
+        
+        // A delay still awake at the second burst wouldn't be testing the wake,
+        // so the render comes back empty and the case fails
+        if (scenario.event == GoldenEvent::sleep && start <= secondBurst && secondBurst < start + goldenBlockSize && !delay->isSleeping()){
+            return {};
+        }
+        if (isAutomated(scenario.state)){
+            automateParameters(*delay, random);
+        }
+        juce::dsp::AudioBlock<SampleType> block (buffer);
+        auto subBlock = block.getSubBlock((size_t) start, (size_t) juce::jmin(goldenBlockSize, goldenNumSamples - start));
+        delay->process(juce::dsp::ProcessContextReplacing<SampleType> (subBlock));
+    }
+    
+    std::vector<float> render;
+    for (int channel = 0; channel < goldenNumChannels; ++channel){
+        for (int sample = 0; sample < goldenNumSamples; ++sample){
+            render.push_back((float) buffer.getSample(channel, sample));
+        }
+    }
+    return render;
+}
+
+std::string getGoldenPath(const std::string& directory, TestSignal signal, const GoldenScenario& scenario){
+    const std::string suffix = *scenario.name != 0 ? std::string("_") + scenario.name : std::string();
+    return directory + "/" + getName(signal) + "_" + getName(scenario.state) + suffix + ".f32";
+}
+
+// Writes the planar float render as reference; both layouts at both precisions are checked against it
+int runGolden(const std::string& directory, bool write, float tolerance){
+    const TestSignal signals[] { TestSignal::impulse, TestSignal::sineSweep, TestSignal::noise };
+    const auto scenarios = getGoldenScenarios();
+    const DelayBufferLayout layouts[] { DelayBufferLayout::planar, DelayBufferLayout::interleaved };
+    
+    int numFailures = 0;
+    bool first = true;
+    std::printf("{\n  \"golden\": [\n");
+    
+    for (auto signal : signals)
+    for (const auto& scenario : scenarios){
+        const auto path = getGoldenPath(directory, signal, scenario);
+        
+        if (write){
+            const auto render = renderGolden<float>(signal, scenario, DelayBufferLayout::planar);
+            std::ofstream file (path, std::ios::binary);
+            file.write(reinterpret_cast<const char*>(render.data()), (std::streamsize) (render.size() * sizeof(float)));
+            const bool written = file.good() && !render.empty();
+            std::printf("%s    { \"file\": \"%s\", \"written\": %s }", first ? "" : ",\n", path.c_str(), written ? "true" : "false");
+            numFailures += written ? 0 : 1;
+            first = false;
+            continue;
+        }
+        
+        std::vector<float> reference ((size_t) goldenNumChannels * goldenNumSamples);
+        std::ifstream file (path, std::ios::binary);
+        file.read(reinterpret_cast<char*>(reference.data()), (std::streamsize) (reference.size() * sizeof(float)));
+        const bool loaded = file.gcount() == (std::streamsize) (reference.size() * sizeof(float));
+        
+        for (auto doublePrecision : { false, true })
+        for (auto layout : layouts){
+            const auto render = doublePrecision ? renderGolden<double>(signal, scenario, layout)
+                                                : renderGolden<float>(signal, scenario, layout);
+            
+            float maxError = 0.0f;
+            for (size_t i = 0; i < render.size(); ++i){
+                maxError = juce::jmax(maxError, std::abs(render[i] - reference[i]));
+            }
+            
+            const bool passed = loaded && render.size() == reference.size() && maxError <= tolerance;
+            numFailures += passed ? 0 : 1;
+            
+            std::printf("%s    { \"signal\": \"%s\", \"state\": \"%s\", \"scenario\": \"%s\", \"layout\": \"%s\", \"precision\": \"%s\", \"maxError\": %g, \"passed\": %s }",
+                        first ? "" : ",\n", getName(signal), getName(scenario.state), scenario.name, getName(layout), doublePrecision ? "double" : "float",
+                        loaded ? maxError : -1.0f, passed ? "true" : "false");
+            first = false;
+        }
+    }
+    
+    std::printf("\n  ],\n  \"failures\": %d\n}\n", numFailures);
+    return numFailures == 0 ? 0 : 1;
+}
+
+}
+
+int main(int argc, char* argv[]){
+    
+    double secondsPerCase = 2.0;
+    bool quick = false;
+    std::string writeBaselinePath, checkBaselinePath, goldenDirectory;
+    bool writeGolden = false;
+    double threshold = 0.15;
+    float tolerance = 3.0e-5f;  // double renders of automation drift about 1.3e-5 from the float reference
+    
+    for (int i = 1; i < argc; ++i){
+        const juce::String argument (argv[i]);
+        const bool hasValue = i + 1 < argc;
+        
+        if (argument == "--seconds" && hasValue){
+            secondsPerCase = juce::String (argv[++i]).getDoubleValue();
+        }
+        else if (argument == "--quick"){
+            quick = true;
+        }
+        else if (argument == "--write-baseline" && hasValue){
+            writeBaselinePath = argv[++i];
+        }
+        else if (argument == "--check-baseline" && hasValue){
+            checkBaselinePath = argv[++i];
+        }
+        else if (argument == "--threshold" && hasValue){
+            threshold = juce::String (argv[++i]).getDoubleValue();
+        }
+        else if ((argument == "--write-golden" || argument == "--check-golden") && hasValue){
+            writeGolden = argument == "--write-golden";
+            goldenDirectory = argv[++i];
+        }
+        else if (argument == "--tolerance" && hasValue){
+            tolerance = (float) juce::String (argv[++i]).getDoubleValue();
+        }
+    }
+    
+    if (!goldenDirectory.empty()){
+        return runGolden(goldenDirectory, writeGolden, tolerance);
+    }
+    
+    // Baseline file: one "<case key> <ns per sample>" line per case
+    std::map<std::string, double> baseline;
+    if (!checkBaselinePath.empty()){
+        std::ifstream baselineFile (checkBaselinePath);
+        std::string key;
+        double nanosecondsPerSample;
+        while (baselineFile >> key >> nanosecondsPerSample){
+            baseline[key] = nanosecondsPerSample;
+        }
+    }
+    std::ofstream baselineOutput;
+    if (!writeBaselinePath.empty()){
+        baselineOutput.open(writeBaselinePath);
+    }
+    int numRegressions = 0;
+    
+    std::vector<double> sampleRates { 44100.0, 48000.0, 96000.0, 192000.0, 384000.0 };
+    std::vector<int> blockSizes { 16, 64, 256, 1024, 4096 };
+    std::vector<int> channelCounts { 1, 2, 4, 8 };
+    std::vector<ParameterState> states { ParameterState::staticParameters, ParameterState::automated,
+                                         ParameterState::modulated, ParameterState::highFeedback,
+                                         ParameterState::multiTap, ParameterState::network,
+                                         ParameterState::shapedFeedback, ParameterState::softOutput,
+                                         ParameterState::jumpAutomated };
+    std::vector<DelayBufferLayout> layouts { DelayBufferLayout::planar, DelayBufferLayout::interleaved };
+    std::vector<int> bankLineCounts { 64, 256 };
+    
+    if (quick){
+        sampleRates = { 48000.0 };
+        blockSizes = { 64, 512 };
+        channelCounts = { 2 };
+        bankLineCounts = { 256 };
+    }
+    
+    std::printf("{\n  \"cyclesAvailable\": %s,\n  \"cases\": [\n", JUCE_INTEL ? "true" : "false");
+    
+    bool first = true;
+    auto report = [&](const std::string& key, const char* layoutName, const char* stateName, const char* precision,
+                      int numChannels, double sampleRate, int blockSize, const BenchmarkResult& result){
+        if (baselineOutput.is_open()){
+            baselineOutput << key << " " << result.nanosecondsPerSample << "\n";
+        }
+        
+        bool regressed = false;
+        auto stored = baseline.find(key);
+        if (stored != baseline.end()){
+            regressed = result.nanosecondsPerSample > stored->second * (1.0 + threshold);
+            numRegressions += regressed ? 1 : 0;
+        }
+        
+        std::printf("%s    { \"layout\": \"%s\", \"state\": \"%s\", \"precision\": \"%s\", \"channels\": %d, \"sampleRate\": %.0f, \"blockSize\": %d, "
+                    "\"nsPerSample\": %.4f, \"realtimeFactor\": %.2f, \"cyclesPerFrame\": %.2f, \"regressed\": %s }",
+                    first ? "" : ",\n", layoutName, stateName, precision, numChannels, sampleRate, blockSize,
+                    result.nanosecondsPerSample, result.realtimeFactor, result.cyclesPerFrame, regressed ? "true" : "false");
+        std::fflush(stdout);
+        first = false;
+    };
+    
+    for (auto layout : layouts)
+    for (auto state : states)
+    for (auto numChannels : channelCounts)
+    for (auto sampleRate : sampleRates)
+    for (auto blockSize : blockSizes){
+        BenchmarkCase benchmarkCase { sampleRate, blockSize, numChannels, state, layout };
+        auto result = runCase<float>(benchmarkCase, secondsPerCase);
+        report(getCaseKey(benchmarkCase), getName(layout), getName(state), "float", numChannels, sampleRate, blockSize, result);
+    }
+    
+    for (auto layout : layouts)
+    for (auto state : states)
+    for (auto sampleRate : sampleRates)
+    for (auto blockSize : blockSizes){
+        BenchmarkCase benchmarkCase { sampleRate, blockSize, 2, state, layout, true };
+        auto result = runCase<double>(benchmarkCase, secondsPerCase);
+        report(getCaseKey(benchmarkCase), getName(layout), getName(state), "double", 2, sampleRate, blockSize, result);
+    }
+    
+    for (auto numLines : bankLineCounts)
+    for (auto sampleRate : sampleRates)
+    for (auto blockSize : blockSizes)
+    for (auto isInline : { false, true }){
+        auto result = runBankCase(sampleRate, blockSize, numLines, isInline ? 0 : -1, secondsPerCase);
+        const char* name = isInline ? "bankInline" : "bank";
+        const auto key = std::string(name) + "/static/" + std::to_string(numLines) + "ch/" + std::to_string((int) sampleRate)
+                       + "/" + std::to_string(blockSize);
+        report(key, name, "static", "float", numLines, sampleRate, blockSize, result);
+    }
+    
+    std::printf("\n  ],\n  \"regressions\": %d\n}\n", numRegressions);
+    return numRegressions == 0 ? 0 : 1;
+}
@@ -0,0 +1,196 @@
+/*
+  ==============================================================================
+
+    PerformanceCounters.cpp
+    Created: 17 Oct 2026 7:02:41pm
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#include "PerformanceCounters.h"
+
+namespace {
+
+void clearSlot(PerformanceSlot& slot){
+    slot.labelSequence.store(0, std::memory_order_relaxed);
+    std::fill(std::begin(slot.label), std::end(slot.label), 0);
+    
+    for (auto* counter : { &slot.sampleRate, &slot.blockSize, &slot.numChannels, &slot.doublePrecision }){
+        counter->store(0, std::memory_order_relaxed);
+    }
+    for (auto* counter : { &slot.numPrepares, &slot.prepareNanos, &slot.worstPrepareNanos,
+                           &slot.numBlocks, &slot.numSamples, &slot.busyNanos, &slot.worstBlockNanos, &slot.worstLoadPpm,
+                           &slot.xrunRiskBlocks, &slot.denormalGuardNanos, &slot.parameterChanges,
+                           &slot.numPaints, &slot.paintNanos, &slot.worstPaintNanos }){
+        counter->store(0, std::memory_order_relaxed);
+    }
+    for (auto& bucket : slot.histogram){
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+}
+
+//==============================================================================
+PerformanceRegistry::PerformanceRegistry(){
+    removeStaleSegments();
+    
+    const auto directory = getPerformanceDirectory();
+    directory.createDirectory();
+    file = directory.getNonexistentChildFile("segment", ".perf", false);
+    
+    // The file is sized up front; the mapping can't grow it
+    juce::MemoryBlock zeros (sizeof(PerformanceSegment), true);
+    if (!file.replaceWithData(zeros.getData(), zeros.getSize())){
+        return;
+    }
+    
+    mapping = std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readWrite);
+    if (mapping->getData() == nullptr || mapping->getSize() < sizeof(PerformanceSegment)){
+        mapping.reset();
+        file.deleteFile();
+        return;
+    }
+    
+    segment = static_cast<PerformanceSegment*>(mapping->getData());
+    segment->version = PERF_SEGMENT_VERSION;
+    segment->numSlots = PERF_MAX_SLOTS;
+    segment->slotSize = sizeof(PerformanceSlot);
+    segment->heartbeatMs.store(juce::Time::currentTimeMillis(), std::memory_order_relaxed);
+    juce::File::getSpecialLocation(juce::File::hostApplicationPath).getFileNameWithoutExtension()
+        .copyToUTF8(segment->processName, PERF_LABEL_LENGTH);
+    
+    // Written last, so the monitor never takes a half-written header for a valid one
+    std::atomic_thread_fence(std::memory_order_release);
+    segment->magic = PERF_SEGMENT_MAGIC;
+    
+    startTimer(PERF_HEARTBEAT_MS);
+}
+
+PerformanceRegistry::~PerformanceRegistry(){
+    stopTimer();
+    
+    if (segment != nullptr){
+        segment = nullptr;
+        mapping.reset();
+        file.deleteFile();
+    }
+}
+
+PerformanceSlot* PerformanceRegistry::claimSlot(){
+    if (segment == nullptr){
+        return nullptr;
+    }
+    
+    for (auto& slot : segment->slots){
+        auto expected = (juce::uint32) PerformanceSlotState::free;
+        if (slot.state.compare_exchange_strong(expected, (juce::uint32) PerformanceSlotState::claimed)){
+            clearSlot(slot);
+            slot.state.store((juce::uint32) PerformanceSlotState::live, std::memory_order_release);
+            return &slot;
+        }
+    }
+    return nullptr;
+}
+
+void PerformanceRegistry::releaseSlot(PerformanceSlot* slot){
+    slot->state.store((juce::uint32) PerformanceSlotState::free, std::memory_order_release);
+}
+
+void PerformanceRegistry::timerCallback(){
+    segment->heartbeatMs.store(juce::Time::currentTimeMillis(), std::memory_order_relaxed);
+}
+
+void PerformanceRegistry::removeStaleSegments(){
+    for (const auto& staleFile : getPerformanceDirectory().findChildFiles(juce::File::findFiles, false, "*.perf")){
+        bool stale = false;
+        {
+            juce::MemoryMappedFile staleMapping (staleFile, juce::MemoryMappedFile::readOnly);
+            const auto* staleSegment = static_cast<const PerformanceSegment*>(staleMapping.getData());
+            stale = staleSegment != nullptr && staleSegment->isValid(staleMapping.getSize()) && staleSegment->isStale();
+        }
+        if (stale){
+            staleFile.deleteFile();
+        }
+    }
+}
+
+//==============================================================================
+PerformanceCounters::PerformanceCounters(){
+    nanosecondsPerTick = 1.0e9 / (double) juce::Time::getHighResolutionTicksPerSecond();
+    
+    if (auto* sharedSlot = registry->claimSlot()){
+        slot = sharedSlot;
+    }
+}
+
+PerformanceCounters::~PerformanceCounters(){
+    if (slot != &privateSlot){
+        registry->releaseSlot(slot);
+    }
+}
+
+void PerformanceCounters::setLabel(const juce::String& newLabel){
+    const auto sequence = slot->labelSequence.load(std::memory_order_relaxed);
+    slot->labelSequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    
+    newLabel.copyToUTF8(slot->label, PERF_LABEL_LENGTH);
+    
+    slot->labelSequence.store(sequence + 2, std::memory_order_release);
+}
+
+void PerformanceCounters::addPrepare(juce::int64 ticks, double sampleRate, int blockSize, int numChannels, bool doublePrecision){
+    budgetPerSample = sampleRate > 0.0 ? 1.0e9 / sampleRate : 0.0;
+    
+    slot->sampleRate.store((juce::int32) sampleRate, std::memory_order_relaxed);
+    slot->blockSize.store(blockSize, std::memory_order_relaxed);
+    slot->numChannels.store(numChannels, std::memory_order_relaxed);
+    slot->doublePrecision.store(doublePrecision ? 1 : 0, std::memory_order_relaxed);
+    
+    const auto nanoseconds = toNanoseconds(ticks);
+    add(slot->numPrepares, 1);
+    add(slot->prepareNanos, nanoseconds);
+    raise(slot->worstPrepareNanos, nanoseconds);
+}
+
+void PerformanceCounters::addPaint(juce::int64 ticks){
+    const auto nanoseconds = toNanoseconds(ticks);
+    add(slot->numPaints, 1);
+    add(slot->paintNanos, nanoseconds);
+    raise(slot->worstPaintNanos, nanoseconds);
+}
+
+void PerformanceCounters::addBlock(juce::int64 ticks, int numSamples){
+    const auto nanoseconds = toNanoseconds(ticks);
+    add(slot->numBlocks, 1);
+    add(slot->numSamples, (juce::uint64) juce::jmax(0, numSamples));
+    add(slot->busyNanos, nanoseconds);
+    raise(slot->worstBlockNanos, nanoseconds);
+    
+    const double budget = numSamples * budgetPerSample;
+    const double load = budget > 0.0 ? (double) nanoseconds / budget : 0.0;
+    raise(slot->worstLoadPpm, (juce::uint64) (load * 1.0e6));
+    
+    if (load >= XRUN_RISK_LOAD){
+        add(slot->xrunRiskBlocks, 1);
+    }
+    
+    // The exponent alone picks the bucket: [0.5, 1) has exponent 0
+    int exponent = -PERF_HISTOGRAM_BUCKETS;
+    if (load > 0.0){
+        std::frexp(load, &exponent);
+    }
+    add(slot->histogram[juce::jlimit(0, PERF_HISTOGRAM_BUCKETS - 1, exponent + PERF_HISTOGRAM_BUCKETS - 2)], 1);
+}
+
+void PerformanceCounters::addDenormalGuard(juce::int64 ticks){
+    add(slot->denormalGuardNanos, toNanoseconds(ticks));
+}
+
+void PerformanceCounters::addParameterChanges(int numChanges){
+    if (numChanges > 0){
+        add(slot->parameterChanges, (juce::uint64) numChanges);
+    }
+}
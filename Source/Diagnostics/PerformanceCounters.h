@@ -0,0 +1,186 @@
+/*
+  ==============================================================================
+
+    PerformanceCounters.h
+    Created: 17 Oct 2026 7:02:41pm
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#define PERF_SEGMENT_MAGIC 0x50524346  // "PRCF"
+#define PERF_SEGMENT_VERSION 1
+#define PERF_MAX_SLOTS 256
+#define PERF_LABEL_LENGTH 64
+#define PERF_HISTOGRAM_BUCKETS 12
+#define PERF_HEARTBEAT_MS 1000
+#define PERF_STALE_SECONDS 10
+#define XRUN_RISK_LOAD 0.8
+
+//==============================================================================
+/*
+    The layout every process publishes its instances' counters in, shared
+    with the monitor tool. Each process maps one file in
+    getPerformanceDirectory() and each plugin instance claims one slot of it.
+
+    Every counter has a single writer: the audio thread for block counters,
+    the message thread for the rest. Writers add with a plain load and store
+    rather than a locked read-modify-write, which keeps recording wait-free.
+    Readers in other processes only ever load.
+
+    Block load is processing time as a fraction of the block's real-time
+    budget. Histogram bucket 0 holds loads under 2^-10; bucket k up to
+    PERF_HISTOGRAM_BUCKETS - 2 holds loads under 2^(k - 10), so the second
+    to last ends at the full budget, and the last holds blocks that overran.
+*/
+enum class PerformanceSlotState : juce::uint32 {
+    free,
+    claimed,  // being reset for a new instance
+    live
+};
+
+struct alignas(64) PerformanceSlot {
+    std::atomic<juce::uint32> state;
+    
+    // Odd while the label is being rewritten, so readers can retry a torn copy
+    std::atomic<juce::uint32> labelSequence;
+    char label[PERF_LABEL_LENGTH];
+    
+    //------------------------------------------------------------------------------
+    // Format, from prepareToPlay
+    std::atomic<juce::int32> sampleRate;
+    std::atomic<juce::int32> blockSize;
+    std::atomic<juce::int32> numChannels;
+    std::atomic<juce::int32> doublePrecision;
+    std::atomic<juce::uint64> numPrepares;
+    std::atomic<juce::uint64> prepareNanos;
+    std::atomic<juce::uint64> worstPrepareNanos;
+    
+    //------------------------------------------------------------------------------
+    // Audio thread
+    alignas(64) std::atomic<juce::uint64> numBlocks;
+    std::atomic<juce::uint64> numSamples;
+    std::atomic<juce::uint64> busyNanos;
+    std::atomic<juce::uint64> worstBlockNanos;
+    std::atomic<juce::uint64> worstLoadPpm;  // millionths of the block budget
+    std::atomic<juce::uint64> xrunRiskBlocks;
+    std::atomic<juce::uint64> denormalGuardNanos;
+    std::atomic<juce::uint64> parameterChanges;
+    std::atomic<juce::uint64> histogram[PERF_HISTOGRAM_BUCKETS];
+    
+    //------------------------------------------------------------------------------
+    // Editor paint
+    alignas(64) std::atomic<juce::uint64> numPaints;
+    std::atomic<juce::uint64> paintNanos;
+    std::atomic<juce::uint64> worstPaintNanos;
+};
+
+struct PerformanceSegment {
+    juce::uint32 magic;
+    juce::uint32 version;
+    juce::uint32 numSlots;
+    juce::uint32 slotSize;
+    std::atomic<juce::int64> heartbeatMs;  // wall clock, refreshed while the process lives
+    char processName[PERF_LABEL_LENGTH];
+    PerformanceSlot slots[PERF_MAX_SLOTS];
+    
+    bool isValid(size_t mappedSize) const {
+        return mappedSize >= sizeof(PerformanceSegment) && magic == PERF_SEGMENT_MAGIC && version == PERF_SEGMENT_VERSION
+            && numSlots == PERF_MAX_SLOTS && slotSize == sizeof(PerformanceSlot);
+    }
+    
+    // A crashed process leaves its segment behind with the heartbeat stopped
+    bool isStale() const {
+        return juce::Time::currentTimeMillis() - heartbeatMs.load(std::memory_order_relaxed) > PERF_STALE_SECONDS * 1000;
+    }
+};
+
+// Other processes read the segment through their own mapping, so the
+// counters must never fall back to a lock inside std::atomic
+static_assert(std::atomic<juce::uint64>::is_always_lock_free && std::atomic<juce::int64>::is_always_lock_free,
+              "Shared performance counters need lock-free 64-bit atomics");
+
+inline juce::File getPerformanceDirectory(){
+    return juce::File::getSpecialLocation(juce::File::tempDirectory).getChildFile("ProcrastinatorPerformance");
+}
+
+//==============================================================================
+/*
+    Maps this process's segment and hands out its slots. Held through a
+    juce::SharedResourcePointer, so the segment exists while any instance
+    does and its file is deleted with the last one. A timer keeps the
+    heartbeat going, and segments left behind by crashed processes are
+    removed when a new one is created.
+*/
+class PerformanceRegistry : private juce::Timer {
+public:
+    PerformanceRegistry();
+    ~PerformanceRegistry() override;
+    
+    // nullptr when the segment couldn't be mapped or every slot is taken
+    PerformanceSlot* claimSlot();
+    void releaseSlot(PerformanceSlot* slot);
+    
+private:
+    juce::File file;
+    std::unique_ptr<juce::MemoryMappedFile> mapping;
+    PerformanceSegment* segment = nullptr;
+    
+    void timerCallback() override;
+    static void removeStaleSegments();
+    
+    JUCE_DECLARE_NON_COPYABLE (PerformanceRegistry)
+};
+
+//==============================================================================
+/*
+    One plugin instance's counters. Recording into a slot is wait-free and
+    never allocates, so the add functions are safe on the audio thread.
+    Without a shared slot the counters land in a private one, so recording
+    never branches on whether the monitor can see them.
+*/
+class PerformanceCounters {
+public:
+    PerformanceCounters();
+    ~PerformanceCounters();
+    
+    //------------------------------------------------------------------------------
+    // Message thread
+    void setLabel(const juce::String& newLabel);
+    void addPrepare(juce::int64 ticks, double sampleRate, int blockSize, int numChannels, bool doublePrecision);
+    void addPaint(juce::int64 ticks);
+    
+    //------------------------------------------------------------------------------
+    // Audio thread
+    void addBlock(juce::int64 ticks, int numSamples);
+    void addDenormalGuard(juce::int64 ticks);
+    void addParameterChanges(int numChanges);
+    
+private:
+    juce::SharedResourcePointer<PerformanceRegistry> registry;
+    PerformanceSlot privateSlot {};
+    PerformanceSlot* slot = &privateSlot;
+    
+    double nanosecondsPerTick = 1.0;
+    double budgetPerSample = 0.0;  // 1 / sample rate, in nanoseconds
+    
+    // Single writer, so a plain load and store is enough and never waits
+    static void add(std::atomic<juce::uint64>& counter, juce::uint64 amount){
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+    
+    static void raise(std::atomic<juce::uint64>& counter, juce::uint64 value){
+        if (value > counter.load(std::memory_order_relaxed)){
+            counter.store(value, std::memory_order_relaxed);
+        }
+    }
+    
+    juce::uint64 toNanoseconds(juce::int64 ticks) const {
+        return (juce::uint64) juce::jmax((juce::int64) 0, (juce::int64) ((double) ticks * nanosecondsPerTick));
+    }
+    
+    JUCE_DECLARE_NON_COPYABLE (PerformanceCounters)
+};
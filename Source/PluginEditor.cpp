@@ -1,124 +1,147 @@
-/*
-  ==============================================================================
-
-    This file contains the basic framework code for a JUCE plugin editor.
-
-  ==============================================================================
-*/
-
-#include "PluginProcessor.h"
-#include "PluginEditor.h"
-
-//==============================================================================
-ProcrastinatorAudioProcessorEditor::ProcrastinatorAudioProcessorEditor (ProcrastinatorAudioProcessor& p)
-    : AudioProcessorEditor (&p), audioProcessor (p),
-mix(audioProcessor.treeState, "MIX", "Mix"), delay(audioProcessor.treeState, "DELAYTIME", "Delay"), feedback(audioProcessor.treeState, "FEEDBACK", "Feedback"), rate(audioProcessor.treeState, "RATE", "Rate"), depth(audioProcessor.treeState, "DEPTH", "Depth"), power(audioProcessor.treeState, "POWER"), led(juce::Colours::red)
-{
-    int width = 300;
-    int height = width * 7/5;
-    setSize (width, height);
-    
-    addAndMakeVisible(mix);
-    addAndMakeVisible(delay);
-    addAndMakeVisible(feedback);
-    addAndMakeVisible(rate);
-    addAndMakeVisible(depth);
-    
-    addAndMakeVisible(power);
-    power.getButton().onClick = [this] { togglePowerLED(); };
-    
-    led.setRadius(10.0f);
-    addAndMakeVisible(led);
-    
-    ledLabel.setColour(juce::Label::ColourIds::textColourId, juce::Colours::white);
-    ledLabel.setJustificationType(juce::Justification::centred);
-    ledLabel.setFont(juce::FontOptions(9.0f));
-    ledLabel.setText(ledName, juce::dontSendNotification);
-    addAndMakeVisible(ledLabel);
-    
-    pedalLabel.setColour(juce::Label::ColourIds::textColourId, juce::Colours::white);
-    pedalLabel.setJustificationType(juce::Justification::centred);
-    pedalLabel.setFont(juce::FontOptions(30.0f));
-    pedalLabel.setText(pedalName, juce::dontSendNotification);
-    addAndMakeVisible(pedalLabel);
-}
-
-ProcrastinatorAudioProcessorEditor::~ProcrastinatorAudioProcessorEditor()
-{
-}
-
-//==============================================================================
-void ProcrastinatorAudioProcessorEditor::paint (juce::Graphics& g)
-{
-    juce::Colour bgColour = juce::Colours::darkslateblue;
-    
-    juce::ColourGradient cg = juce::ColourGradient::vertical(bgColour.darker(0.0), 10, bgColour.darker(1.0f), 0);
-    g.setGradientFill(cg);
-    g.fillAll ();
-    
-    // Create drop off shadow
-//    int dropoffX = 0;
-//    int dropoffY = pedalLabel.getY();
-//    int dropoffWidth = getWidth();
-//    int dropoffHeight = 5;
-//    juce::Rectangle dropoff = juce::Rectangle<int> (dropoffX, dropoffY, dropoffWidth, dropoffHeight);
-//    g.drawRect(dropoff);
-//    g.fillRect(dropoff);
-}
-
-void ProcrastinatorAudioProcessorEditor::resized()
-{
-    renderDials();
-    renderPowerSwitch();
-    renderLED();
-}
-
-void ProcrastinatorAudioProcessorEditor::togglePowerLED(){
-    if (power.getButton().getToggleState() == true){
-        led.toggleOn();
-    }
-    else{
-        led.toggleOff();
-    }
-}
-
-void ProcrastinatorAudioProcessorEditor::renderDials(){
-    int dialWidth = getWidth() / 3;
-    int dialHeight = getHeight() / 5;
-    
-    rate.setBounds(0, 0, dialWidth, dialHeight);
-    depth.setBounds(getWidth() - dialWidth, 0, dialWidth, dialHeight);
-    
-    int bottomRowY = rate.getBottom();
-    mix.setBounds(0, bottomRowY, dialWidth, dialHeight);
-    delay.setBounds(mix.getRight(), bottomRowY, dialWidth, dialHeight);
-    feedback.setBounds(delay.getRight(), bottomRowY, dialWidth, dialHeight);
-}
-
-void ProcrastinatorAudioProcessorEditor::renderPowerSwitch(){
-    int bottomMargin = 20;
-    int powerSwitchWidth = getWidth() * 0.75;
-    int powerSwitchHeight = getHeight() * 0.35;
-    int powerX = getWidth() / 2 - powerSwitchWidth / 2;
-    int powerY = getHeight() - powerSwitchHeight - bottomMargin;
-    power.setBounds(powerX, powerY, powerSwitchWidth, powerSwitchHeight);
-}
-
-void ProcrastinatorAudioProcessorEditor::renderLED(){
-    int ledRadius = 40.0f;
-    int ledX = getWidth() / 2 - ledRadius / 2;
-    int ledY = 25;
-    led.setBounds(ledX, ledY, ledRadius, ledRadius);
-    
-    int ledLabelWidth = 40;
-    int ledLabelHeight = 20;
-    int ledLabelX = led.getX();
-    int ledLabelY = led.getY() - 5;
-    ledLabel.setBounds(ledLabelX, ledLabelY, ledLabelWidth, ledLabelHeight);
-    
-    int labelWidth = getWidth();
-    int labelHeight = power.getY() - mix.getBottom();
-    int labelX = getWidth() / 2 - labelWidth / 2;
-    int labelY = mix.getBottom();
-    pedalLabel.setBounds(labelX, labelY, labelWidth, labelHeight);
-}
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin editor.
+
+  ==============================================================================
+*/
+
+#include "PluginProcessor.h"
+#include "PluginEditor.h"
+
+//==============================================================================
+ProcrastinatorAudioProcessorEditor::ProcrastinatorAudioProcessorEditor (ProcrastinatorAudioProcessor& p)
+    : AudioProcessorEditor (&p), audioProcessor (p),
+mix(audioProcessor.treeState, "MIX", "Mix"), delay(audioProcessor.treeState, "DELAYTIME_MS", "Delay"), feedback(audioProcessor.treeState, "FEEDBACK", "Feedback"), rate(audioProcessor.treeState, "RATE", "Rate"), depth(audioProcessor.treeState, "DEPTH", "Depth"), power(audioProcessor.treeState, "POWER"), led(juce::Colours::red), echoView(audioProcessor.getSignalFeed(), audioProcessor.treeState.getRawParameterValue("DELAYTIME_MS"))
+{
+    int width = 300;
+    int height = width * 7/5;
+    setSize (width, height + ECHO_VIEW_HEIGHT);
+    
+    // The background covers everything, so the host's window needn't be painted behind it
+    setOpaque(true);
+    
+    addAndMakeVisible(mix);
+    addAndMakeVisible(delay);
+    addAndMakeVisible(feedback);
+    addAndMakeVisible(rate);
+    addAndMakeVisible(depth);
+    
+    addAndMakeVisible(power);
+    power.getButton().onClick = [this] { togglePowerLED(); };
+    
+    led.setRadius(10.0f);
+    addAndMakeVisible(led);
+    
+    addAndMakeVisible(echoView);
+    
+    ledLabel.setColour(juce::Label::ColourIds::textColourId, juce::Colours::white);
+    ledLabel.setJustificationType(juce::Justification::centred);
+    ledLabel.setFont(juce::FontOptions(9.0f));
+    ledLabel.setText(ledName, juce::dontSendNotification);
+    addAndMakeVisible(ledLabel);
+    
+    pedalLabel.setColour(juce::Label::ColourIds::textColourId, juce::Colours::white);
+    pedalLabel.setJustificationType(juce::Justification::centred);
+    pedalLabel.setFont(juce::FontOptions(30.0f));
+    pedalLabel.setText(pedalName, juce::dontSendNotification);
+    addAndMakeVisible(pedalLabel);
+}
+
+ProcrastinatorAudioProcessorEditor::~ProcrastinatorAudioProcessorEditor()
+{
+}
+
+//==============================================================================
+void ProcrastinatorAudioProcessorEditor::paint (juce::Graphics& g)
+{
+    paintStartTicks = juce::Time::getHighResolutionTicks();
+    
+    auto background = renderCache->getImage(CachedImage::editorBackground, getWidth(), getHeight(), RenderCache::getScale(g), 0, drawBackground);
+    g.drawImage(background, getLocalBounds().toFloat());
+    
+    // Create drop off shadow
+//    int dropoffX = 0;
+//    int dropoffY = pedalLabel.getY();
+//    int dropoffWidth = getWidth();
+//    int dropoffHeight = 5;
+//    juce::Rectangle dropoff = juce::Rectangle<int> (dropoffX, dropoffY, dropoffWidth, dropoffHeight);
+//    g.drawRect(dropoff);
+//    g.fillRect(dropoff);
+}
+
+void ProcrastinatorAudioProcessorEditor::drawBackground (juce::Graphics& g)
+{
+    juce::Colour bgColour = juce::Colours::darkslateblue;
+    
+    juce::ColourGradient cg = juce::ColourGradient::vertical(bgColour.darker(0.0), 10, bgColour.darker(1.0f), 0);
+    g.setGradientFill(cg);
+    g.fillAll ();
+}
+
+void ProcrastinatorAudioProcessorEditor::paintOverChildren (juce::Graphics& g)
+{
+    audioProcessor.getPerformanceCounters().addPaint(juce::Time::getHighResolutionTicks() - paintStartTicks);
+}
+
+void ProcrastinatorAudioProcessorEditor::resized()
+{
+    renderDials();
+    renderPowerSwitch();
+    renderLED();
+    renderEchoView();
+}
+
+void ProcrastinatorAudioProcessorEditor::togglePowerLED(){
+    if (power.getButton().getToggleState() == true){
+        led.toggleOn();
+    }
+    else{
+        led.toggleOff();
+    }
+}
+
+void ProcrastinatorAudioProcessorEditor::renderDials(){
+    int dialWidth = getWidth() / 3;
+    int dialHeight = getPedalHeight() / 5;
+    
+    rate.setBounds(0, 0, dialWidth, dialHeight);
+    depth.setBounds(getWidth() - dialWidth, 0, dialWidth, dialHeight);
+    
+    int bottomRowY = rate.getBottom();
+    mix.setBounds(0, bottomRowY, dialWidth, dialHeight);
+    delay.setBounds(mix.getRight(), bottomRowY, dialWidth, dialHeight);
+    feedback.setBounds(delay.getRight(), bottomRowY, dialWidth, dialHeight);
+}
+
+void ProcrastinatorAudioProcessorEditor::renderPowerSwitch(){
+    int bottomMargin = 20;
+    int powerSwitchWidth = getWidth() * 0.75;
+    int powerSwitchHeight = getPedalHeight() * 0.35;
+    int powerX = getWidth() / 2 - powerSwitchWidth / 2;
+    int powerY = getPedalHeight() - powerSwitchHeight - bottomMargin;
+    power.setBounds(powerX, powerY, powerSwitchWidth, powerSwitchHeight);
+}
+
+void ProcrastinatorAudioProcessorEditor::renderLED(){
+    int ledRadius = 40.0f;
+    int ledX = getWidth() / 2 - ledRadius / 2;
+    int ledY = 25;
+    led.setBounds(ledX, ledY, ledRadius, ledRadius);
+    
+    int ledLabelWidth = 40;
+    int ledLabelHeight = 20;
+    int ledLabelX = led.getX();
+    int ledLabelY = led.getY() - 5;
+    ledLabel.setBounds(ledLabelX, ledLabelY, ledLabelWidth, ledLabelHeight);
+    
+    int labelWidth = getWidth();
+    int labelHeight = power.getY() - mix.getBottom();
+    int labelX = getWidth() / 2 - labelWidth / 2;
+    int labelY = mix.getBottom();
+    pedalLabel.setBounds(labelX, labelY, labelWidth, labelHeight);
+}
+
+void ProcrastinatorAudioProcessorEditor::renderEchoView(){
+    echoView.setBounds(0, getPedalHeight(), getWidth(), ECHO_VIEW_HEIGHT);
+}
@@ -1,56 +1,74 @@
-/*
-  ==============================================================================
-
-    This file contains the basic framework code for a JUCE plugin editor.
-
-  ==============================================================================
-*/
-
-#pragma once
-
-#include <JuceHeader.h>
-#include "PluginProcessor.h"
-#include "UI/Dial.h"
-#include "UI/PowerSwitch.h"
-#include "UI/PowerLED.h"
-
-//==============================================================================
-/**
-*/
-class ProcrastinatorAudioProcessorEditor  : public juce::AudioProcessorEditor
-{
-public:
-    ProcrastinatorAudioProcessorEditor (ProcrastinatorAudioProcessor&);
-    ~ProcrastinatorAudioProcessorEditor() override;
-
-    //==============================================================================
-    void paint (juce::Graphics&) override;
-    void resized() override;
-    void togglePowerLED();
-
-private:
-    // This reference is provided as a quick way for your editor to
-    // access the processor object that created it.
-    ProcrastinatorAudioProcessor& audioProcessor;
-    
-    Dial mix;
-    Dial delay;
-    Dial feedback;
-    Dial rate;
-    Dial depth;
-    
-    PowerSwitch power;
-    PowerLED led;
-    
-    juce::String ledName = "Power";
-    juce::Label ledLabel {"LEDLABEL", ledName};
-    
-    juce::String pedalName = "Replicator";
-    juce::Label pedalLabel {"PEDALLABEL", pedalName};
-    
-    void renderDials();
-    void renderPowerSwitch();
-    void renderLED();
-
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ProcrastinatorAudioProcessorEditor)
-};
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin editor.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+#include "UI/Dial.h"
+#include "UI/PowerSwitch.h"
+#include "UI/PowerLED.h"
+#include "UI/RenderCache.h"
+#include "UI/EchoView.h"
+
+//==============================================================================
+/**
+*/
+class ProcrastinatorAudioProcessorEditor  : public juce::AudioProcessorEditor
+{
+public:
+    ProcrastinatorAudioProcessorEditor (ProcrastinatorAudioProcessor&);
+    ~ProcrastinatorAudioProcessorEditor() override;
+
+    //==============================================================================
+    void paint (juce::Graphics&) override;
+    void paintOverChildren (juce::Graphics&) override;
+    void resized() override;
+    void togglePowerLED();
+
+private:
+    // This reference is provided as a quick way for your editor to
+    // access the processor object that created it.
+    ProcrastinatorAudioProcessor& audioProcessor;
+    
+    Dial mix;
+    Dial delay;
+    Dial feedback;
+    Dial rate;
+    Dial depth;
+    
+    PowerSwitch power;
+    PowerLED led;
+    
+    EchoView echoView;
+    
+    juce::String ledName = "Power";
+    juce::Label ledLabel {"LEDLABEL", ledName};
+    
+    juce::String pedalName = "Replicator";
+    juce::Label pedalLabel {"PEDALLABEL", pedalName};
+    
+    // Holds the background, and the dials' and LED's images, for every open editor
+    juce::SharedResourcePointer<RenderCache> renderCache;
+    
+    // paint() starts the clock and paintOverChildren() stops it, so the
+    // monitor sees the whole editor including the dials
+    juce::int64 paintStartTicks = 0;
+    
+    void renderDials();
+    void renderPowerSwitch();
+    void renderLED();
+    void renderEchoView();
+    
+    // The pedal keeps its proportions, with the echo view in a strip below it
+    int getPedalHeight() const { return getHeight() - ECHO_VIEW_HEIGHT; }
+    
+    static void drawBackground(juce::Graphics& g);
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ProcrastinatorAudioProcessorEditor)
+};
@@ -1,266 +1,619 @@
-/*
-  ==============================================================================
-
-    This file contains the basic framework code for a JUCE plugin processor.
-
-  ==============================================================================
-*/
-
-#include "PluginProcessor.h"
-#include "PluginEditor.h"
-
-//==============================================================================
-ProcrastinatorAudioProcessor::ProcrastinatorAudioProcessor()
-#ifndef JucePlugin_PreferredChannelConfigurations
-     : AudioProcessor (BusesProperties()
-                     #if ! JucePlugin_IsMidiEffect
-                      #if ! JucePlugin_IsSynth
-                       .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
-                      #endif
-                       .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
-                     #endif
-                       ), treeState(*this, nullptr, "PARAMETERS", createParameterLayout())
-#endif
-{
-    treeState.addParameterListener(paramDelay, this);
-    treeState.addParameterListener(paramMix, this);
-    treeState.addParameterListener(paramFeedback, this);
-    treeState.addParameterListener(paramRate, this);
-    treeState.addParameterListener(paramDepth, this);
-    treeState.addParameterListener(paramPower, this);
-}
-
-ProcrastinatorAudioProcessor::~ProcrastinatorAudioProcessor()
-{
-    treeState.removeParameterListener("DELAYTIME", this);
-    treeState.removeParameterListener("MIX", this);
-    treeState.removeParameterListener("FEEDBACK", this);
-    treeState.removeParameterListener("RATE", this);
-    treeState.removeParameterListener("DEPTH", this);
-    treeState.removeParameterListener("POWER", this);
-}
-
-//==============================================================================
-const juce::String ProcrastinatorAudioProcessor::getName() const
-{
-    return JucePlugin_Name;
-}
-
-bool ProcrastinatorAudioProcessor::acceptsMidi() const
-{
-   #if JucePlugin_WantsMidiInput
-    return true;
-   #else
-    return false;
-   #endif
-}
-
-bool ProcrastinatorAudioProcessor::producesMidi() const
-{
-   #if JucePlugin_ProducesMidiOutput
-    return true;
-   #else
-    return false;
-   #endif
-}
-
-bool ProcrastinatorAudioProcessor::isMidiEffect() const
-{
-   #if JucePlugin_IsMidiEffect
-    return true;
-   #else
-    return false;
-   #endif
-}
-
-double ProcrastinatorAudioProcessor::getTailLengthSeconds() const
-{
-    return 0.0;
-}
-
-int ProcrastinatorAudioProcessor::getNumPrograms()
-{
-    return 1;   // NB: some hosts don't cope very well if you tell them there are 0 programs,
-                // so this should be at least 1, even if you're not really implementing programs.
-}
-
-int ProcrastinatorAudioProcessor::getCurrentProgram()
-{
-    return 0;
-}
-
-void ProcrastinatorAudioProcessor::setCurrentProgram (int index)
-{
-}
-
-const juce::String ProcrastinatorAudioProcessor::getProgramName (int index)
-{
-    return {};
-}
-
-void ProcrastinatorAudioProcessor::changeProgramName (int index, const juce::String& newName)
-{
-}
-
-//==============================================================================
-void ProcrastinatorAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
-{
-    auto numInputChannels = getTotalNumInputChannels();
-    lastSampleRate = sampleRate;
-    
-    delayLine.prepareToPlay(sampleRate, samplesPerBlock, numInputChannels);
-    updateParameters();
-}
-
-void ProcrastinatorAudioProcessor::releaseResources()
-{
-    // When playback stops, you can use this as an opportunity to free up any
-    // spare memory, etc.
-}
-
-#ifndef JucePlugin_PreferredChannelConfigurations
-bool ProcrastinatorAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
-{
-  #if JucePlugin_IsMidiEffect
-    juce::ignoreUnused (layouts);
-    return true;
-  #else
-    // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
-    // Some plugin hosts, such as certain GarageBand versions, will only
-    // load plugins that support stereo bus layouts.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
-        return false;
-
-    // This checks if the input layout matches the output layout
-   #if ! JucePlugin_IsSynth
-    if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
-        return false;
-   #endif
-
-    return true;
-  #endif
-}
-#endif
-
-void ProcrastinatorAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
-{
-    juce::ScopedNoDenormals noDenormals;
-    auto totalNumInputChannels  = getTotalNumInputChannels();
-    auto totalNumOutputChannels = getTotalNumOutputChannels();
-
-    for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
-        buffer.clear (i, 0, buffer.getNumSamples());
-    
-    for (int channel = 0; channel < totalNumInputChannels; ++channel){
-        
-        auto* channelData = buffer.getWritePointer(channel);
-        
-        for (int sample = 0; sample < buffer.getNumSamples(); ++sample){
-            if (isOn){
-                channelData[sample] = delayLine.processSample(channel, channelData[sample]);
-            }
-        }
-    }
-}
-
-juce::AudioProcessorValueTreeState::ParameterLayout ProcrastinatorAudioProcessor::createParameterLayout(){
-    std::vector<std::unique_ptr<juce::RangedAudioParameter>> params;
-    
-    auto delayTime_ms = std::make_unique<juce::AudioParameterInt>(juce::ParameterID("DELAYTIME", 1), "Delay", 1, 1000, 500);
-    auto mix = std::make_unique<juce::AudioParameterFloat>(juce::ParameterID("MIX", 1), "Mix", juce::NormalisableRange<float>(0.0f, 1.0f), 0.5f);
-    auto feedback = std::make_unique<juce::AudioParameterFloat>(juce::ParameterID("FEEDBACK", 1), "Feedback", juce::NormalisableRange<float>(0.0f, 0.95f), 0.0f);
-    
-    auto rate = std::make_unique<juce::AudioParameterFloat>(juce::ParameterID("RATE", 1), "Rate", juce::NormalisableRange<float>(0.01f, 10.0f), 0.0f);
-    auto depth = std::make_unique<juce::AudioParameterInt>(juce::ParameterID("DEPTH", 1), "Depth", 0, 10, 0);
-    
-    auto power = std::make_unique<juce::AudioParameterBool>(juce::ParameterID("POWER", 1), "Power", true);
-    
-    params.push_back(std::move(delayTime_ms));
-    params.push_back(std::move(mix));
-    params.push_back(std::move(feedback));
-    params.push_back(std::move(rate));
-    params.push_back(std::move(depth));
-    params.push_back(std::move(power));
-    
-    return {params.begin(), params.end()};
-}
-
-void ProcrastinatorAudioProcessor::parameterChanged(const juce::String &parameterId, float newValue){
-    if (parameterId == paramDelay){
-        delayLine.setDelayLength(newValue);
-    }
-    else if (parameterId == paramMix){
-        delayLine.setMix(newValue);
-    }
-    else if (parameterId == paramFeedback){
-        delayLine.setFeedback(newValue);
-    }
-    else if (parameterId == paramRate){
-        delayLine.setRate(newValue);
-    }
-    else if (parameterId == paramDepth){
-        delayLine.setDepth(newValue);
-    }
-    else if (parameterId == paramPower){
-        updatePower();
-    }
-}
-
-void ProcrastinatorAudioProcessor::updateParameters(){
-    int delayTime_ms = treeState.getRawParameterValue("DELAYTIME")->load();
-    delayLine.setDelayLength(delayTime_ms);
-    
-    float mix = treeState.getRawParameterValue("MIX")->load();
-    delayLine.setMix(mix);
-    
-    float feedback = treeState.getRawParameterValue("FEEDBACK")->load();
-    delayLine.setFeedback(feedback);
-    
-    float rate = treeState.getRawParameterValue("RATE")->load();
-    delayLine.setRate(rate);
-    
-    int depth = treeState.getRawParameterValue("DEPTH")->load();
-    delayLine.setDepth(depth);
-}
-
-void ProcrastinatorAudioProcessor::updatePower(){
-    isOn = treeState.getRawParameterValue("POWER")->load();
-    if (!isOn){
-        delayLine.clearDelayLine();
-    }
-}
-
-//==============================================================================
-bool ProcrastinatorAudioProcessor::hasEditor() const
-{
-    return true; // (change this to false if you choose to not supply an editor)
-}
-
-juce::AudioProcessorEditor* ProcrastinatorAudioProcessor::createEditor()
-{
-    return new ProcrastinatorAudioProcessorEditor (*this);
-//    return new juce::GenericAudioProcessorEditor(*this);
-}
-
-//==============================================================================
-void ProcrastinatorAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
-{
-    // You should use this method to store your parameters in the memory block.
-    // You could do that either as raw data, or use the XML or ValueTree classes
-    // as intermediaries to make it easy to save and load complex data.
-}
-
-void ProcrastinatorAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
-{
-    // You should use this method to restore your parameters from this memory block,
-    // whose contents will have been created by the getStateInformation() call.
-}
-
-//==============================================================================
-// This creates new instances of the plugin..
-juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
-{
-    return new ProcrastinatorAudioProcessor();
-}
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin processor.
+
+  ==============================================================================
+*/
+
+#include "PluginProcessor.h"
+#include "PluginEditor.h"
+
+//==============================================================================
+ProcrastinatorAudioProcessor::ProcrastinatorAudioProcessor()
+#ifndef JucePlugin_PreferredChannelConfigurations
+     : AudioProcessor (BusesProperties()
+                     #if ! JucePlugin_IsMidiEffect
+                      #if ! JucePlugin_IsSynth
+                       .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
+                      #endif
+                       .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
+                     #endif
+                       ), treeState(*this, nullptr, "PARAMETERS", createParameterLayout())
+#endif
+{
+    delayParameter    = treeState.getRawParameterValue(paramDelay);
+    mixParameter      = treeState.getRawParameterValue(paramMix);
+    feedbackParameter = treeState.getRawParameterValue(paramFeedback);
+    rateParameter     = treeState.getRawParameterValue(paramRate);
+    depthParameter    = treeState.getRawParameterValue(paramDepth);
+    powerParameter    = treeState.getRawParameterValue(paramPower);
+    qualityParameter  = treeState.getRawParameterValue(paramQuality);
+    budgetParameter   = treeState.getRawParameterValue(paramBudget);
+    snapshotParameter = treeState.getRawParameterValue(paramSnapshot);
+    networkParameter  = treeState.getRawParameterValue(paramNetwork);
+    highCutParameter  = treeState.getRawParameterValue(paramHighCut);
+    lowCutParameter   = treeState.getRawParameterValue(paramLowCut);
+    saturationParameter = treeState.getRawParameterValue(paramSaturation);
+    outputShapeParameter = treeState.getRawParameterValue(paramOutputShape);
+    timeModeParameter = treeState.getRawParameterValue(paramTimeMode);
+    tapsParameter     = treeState.getRawParameterValue(paramTaps);
+    for (int tap = 0; tap < MAX_TAPS; ++tap){
+        tapTimeParameters[tap] = treeState.getRawParameterValue(getTapParameterID(tap, "TIME"));
+        tapGainParameters[tap] = treeState.getRawParameterValue(getTapParameterID(tap, "GAIN"));
+        tapPanParameters[tap]  = treeState.getRawParameterValue(getTapParameterID(tap, "PAN"));
+        tapSendParameters[tap] = treeState.getRawParameterValue(getTapParameterID(tap, "SEND"));
+    }
+    
+    lastParameterValues.resize((size_t) getParameters().size());
+    countParameterChanges();
+}
+
+ProcrastinatorAudioProcessor::~ProcrastinatorAudioProcessor()
+{
+}
+
+//==============================================================================
+const juce::String ProcrastinatorAudioProcessor::getName() const
+{
+    return JucePlugin_Name;
+}
+
+bool ProcrastinatorAudioProcessor::acceptsMidi() const
+{
+   #if JucePlugin_WantsMidiInput
+    return true;
+   #else
+    return false;
+   #endif
+}
+
+bool ProcrastinatorAudioProcessor::producesMidi() const
+{
+   #if JucePlugin_ProducesMidiOutput
+    return true;
+   #else
+    return false;
+   #endif
+}
+
+bool ProcrastinatorAudioProcessor::isMidiEffect() const
+{
+   #if JucePlugin_IsMidiEffect
+    return true;
+   #else
+    return false;
+   #endif
+}
+
+double ProcrastinatorAudioProcessor::getTailLengthSeconds() const
+{
+    // Each trip round the feedback loop is loop gain times quieter, so the
+    // tail lasts as many repeats as it takes to fall below the silence
+    // threshold, each as long as the longest read. Rounding to a prime
+    // puts the network's longest line well under a millisecond past the
+    // delay time; taps replace the single head, and feed back through their sends.
+    double longest_ms = delayParameter->load();
+    double loopGain = feedbackParameter->load();
+    
+    const int numTaps = (int) tapsParameter->load();
+    if (networkParameter->load() > 0.5f){
+        longest_ms += 1.0;
+    }
+    else if (numTaps > 0){
+        longest_ms = 0.0;
+        double totalSend = 0.0;
+        for (int tap = 0; tap < numTaps; ++tap){
+            longest_ms = juce::jmax(longest_ms, (double) tapTimeParameters[tap]->load());
+            totalSend += tapSendParameters[tap]->load();
+        }
+        loopGain *= totalSend;
+    }
+    
+    if (loopGain >= 1.0){
+        return std::numeric_limits<double>::infinity();
+    }
+    
+    double numRepeats = 1.0;
+    if (loopGain > 0.0){
+        numRepeats += std::ceil(std::log(SILENCE_THRESHOLD) / std::log(loopGain));
+    }
+    return 0.001 * (longest_ms + depthParameter->load()) * numRepeats;
+}
+
+int ProcrastinatorAudioProcessor::getNumPrograms()
+{
+    return 1;   // NB: some hosts don't cope very well if you tell them there are 0 programs,
+                // so this should be at least 1, even if you're not really implementing programs.
+}
+
+int ProcrastinatorAudioProcessor::getCurrentProgram()
+{
+    return 0;
+}
+
+void ProcrastinatorAudioProcessor::setCurrentProgram (int index)
+{
+}
+
+const juce::String ProcrastinatorAudioProcessor::getProgramName (int index)
+{
+    return {};
+}
+
+void ProcrastinatorAudioProcessor::changeProgramName (int index, const juce::String& newName)
+{
+}
+
+//==============================================================================
+void ProcrastinatorAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
+{
+    const auto startTicks = juce::Time::getHighResolutionTicks();
+    
+    lastSampleRate = sampleRate;
+    governor.prepare(sampleRate);
+    signalFeed.prepare(sampleRate, samplesPerBlock);
+    
+    // The host sets the precision before preparing, and prepares again to change it
+    if (isUsingDoublePrecision()){
+        prepareDelay(doubleDelayLine, sampleRate, samplesPerBlock);
+    }
+    else {
+        prepareDelay(delayLine, sampleRate, samplesPerBlock);
+    }
+    
+    isPrepared = true;
+    applyPendingSnapshot();
+    
+    performanceCounters.addPrepare(juce::Time::getHighResolutionTicks() - startTicks, sampleRate, samplesPerBlock,
+                                   getTotalNumInputChannels(), isUsingDoublePrecision());
+}
+
+template <typename SampleType>
+void ProcrastinatorAudioProcessor::prepareDelay (Delay<SampleType>& delay, double sampleRate, int samplesPerBlock)
+{
+    auto numInputChannels = getTotalNumInputChannels();
+    
+    // Set before preparing, so the delay starts in the right state without a fade
+    isOn = powerParameter->load() > 0.5f;
+    delay.setBypassed(!isOn);
+    delay.setLongDelayMode(true);
+    
+    // Surround and ambisonic buses share their channel groups out over the
+    // pool; the delay still runs blocks too small to pay for it inline
+    delay.setParallelGroups(numInputChannels >= MIN_PARALLEL_CHANNELS);
+    
+    // Lagrange plays at the high and medium tiers; only low drops to linear
+    delay.prepareToPlay(sampleRate, samplesPerBlock, numInputChannels, DelayBufferLayout::interleaved, DelayInterpolation::lagrange3);
+    appliedNumTaps = 0;
+    updateParameters(delay);
+    updateQuality(delay);
+}
+
+void ProcrastinatorAudioProcessor::releaseResources()
+{
+    // When playback stops, you can use this as an opportunity to free up any
+    // spare memory, etc.
+}
+
+#ifndef JucePlugin_PreferredChannelConfigurations
+bool ProcrastinatorAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
+{
+  #if JucePlugin_IsMidiEffect
+    juce::ignoreUnused (layouts);
+    return true;
+  #else
+    // Any main bus from mono up to MAX_CHANNELS is supported, which covers
+    // 5.1, 7.1.4 and ambisonics up to seventh order. Stereo stays the
+    // default, since some hosts will only load stereo plugins.
+    const auto& mainOutput = layouts.getMainOutputChannelSet();
+    if (mainOutput.isDisabled() || mainOutput.size() > MAX_CHANNELS)
+        return false;
+    
+    // This checks if the input layout matches the output layout
+   #if ! JucePlugin_IsSynth
+    if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
+        return false;
+   #endif
+    
+    return true;
+  #endif
+}
+#endif
+
+void ProcrastinatorAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    processBlockWith(buffer, delayLine);
+}
+
+// A 64-bit host bus runs through the double delay as it is, with no
+// conversion copies either side and the feedback recirculating in double
+void ProcrastinatorAudioProcessor::processBlock (juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages)
+{
+    processBlockWith(buffer, doubleDelayLine);
+}
+
+// The host's bypass fades out like the power switch, and keeps the delay
+// quiet until it is switched back in
+void ProcrastinatorAudioProcessor::processBlockBypassed (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    processBlockBypassedWith(buffer, delayLine);
+}
+
+void ProcrastinatorAudioProcessor::processBlockBypassed (juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages)
+{
+    processBlockBypassedWith(buffer, doubleDelayLine);
+}
+
+bool ProcrastinatorAudioProcessor::supportsDoublePrecisionProcessing() const
+{
+    return true;
+}
+
+template <typename SampleType>
+void ProcrastinatorAudioProcessor::processBlockWith (juce::AudioBuffer<SampleType>& buffer, Delay<SampleType>& delay)
+{
+    // Switching the FPU to flush denormals can stall the pipeline on some
+    // CPUs, so the monitor gets its cost on its own
+    const auto startTicks = juce::Time::getHighResolutionTicks();
+    juce::ScopedNoDenormals noDenormals;
+    performanceCounters.addDenormalGuard(juce::Time::getHighResolutionTicks() - startTicks);
+    
+    updatePower(delay, false);
+    updateParameters(delay);
+    updateQuality(delay);
+    performanceCounters.addParameterChanges(countParameterChanges());
+    
+    processDelay(buffer, delay);
+    
+    const auto elapsedTicks = juce::Time::getHighResolutionTicks() - startTicks;
+    governor.addMeasurement(juce::Time::highResolutionTicksToSeconds(elapsedTicks), buffer.getNumSamples());
+    performanceCounters.addBlock(elapsedTicks, buffer.getNumSamples());
+}
+
+template <typename SampleType>
+void ProcrastinatorAudioProcessor::processBlockBypassedWith (juce::AudioBuffer<SampleType>& buffer, Delay<SampleType>& delay)
+{
+    juce::ScopedNoDenormals noDenormals;
+    
+    updatePower(delay, true);
+    processDelay(buffer, delay);
+}
+
+template <typename SampleType>
+void ProcrastinatorAudioProcessor::processDelay (juce::AudioBuffer<SampleType>& buffer, Delay<SampleType>& delay)
+{
+    auto totalNumInputChannels  = getTotalNumInputChannels();
+    auto totalNumOutputChannels = getTotalNumOutputChannels();
+    
+    for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
+        buffer.clear (i, 0, buffer.getNumSamples());
+    
+    // Read once, so a view opening mid-block can't catch only the output half
+    const bool visualising = signalFeed.isEnabled();
+    if (visualising){
+        signalFeed.addInput(buffer, totalNumInputChannels);
+    }
+    
+    delay.setNonRealtime(isNonRealtime());
+    
+    // Once bypassed and faded out, this returns before touching a sample
+    juce::dsp::AudioBlock<SampleType> block (buffer);
+    auto inputBlock = block.getSubsetChannelBlock(0, (size_t) totalNumInputChannels);
+    delay.process(juce::dsp::ProcessContextReplacing<SampleType> (inputBlock));
+    
+    if (visualising){
+        signalFeed.addOutput(buffer, totalNumInputChannels);
+    }
+}
+
+juce::AudioProcessorValueTreeState::ParameterLayout ProcrastinatorAudioProcessor::createParameterLayout(){
+    std::vector<std::unique_ptr<juce::RangedAudioParameter>> params;
+    
+    // Long-delay mode reaches a minute; the skew keeps the short echoes at the centre of the dial.
+    // The ID is new because the old DELAYTIME was an integer from 1 to 1000, and hosts
+    // would replay its automation onto this range.
+    juce::NormalisableRange<float> delayRange(1.0f, 60000.0f, 1.0f);
+    delayRange.setSkewForCentre(500.0f);
+    auto delayTime_ms = std::make_unique<juce::AudioParameterFloat>(juce::ParameterID("DELAYTIME_MS", 2), "Delay", delayRange, 500.0f);
+    
+    // How the head follows the delay time, in DelayTimeMode order
+    auto timeMode = std::make_unique<juce::AudioParameterChoice>(juce::ParameterID("TIMEMODE", 1), "Time Mode", juce::StringArray { "Tape", "Jump" }, 0);
+    
+    auto mix = std::make_unique<juce::AudioParameterFloat>(juce::ParameterID("MIX", 1), "Mix", juce::NormalisableRange<float>(0.0f, 1.0f), 0.5f);
+    auto feedback = std::make_unique<juce::AudioParameterFloat>(juce::ParameterID("FEEDBACK", 1), "Feedback", juce::NormalisableRange<float>(0.0f, 0.95f), 0.0f);
+    
+    auto rate = std::make_unique<juce::AudioParameterFloat>(juce::ParameterID("RATE", 1), "Rate", juce::NormalisableRange<float>(0.01f, 10.0f), 0.0f);
+    auto depth = std::make_unique<juce::AudioParameterInt>(juce::ParameterID("DEPTH", 1), "Depth", 0, 10, 0);
+    
+    auto power = std::make_unique<juce::AudioParameterBool>(juce::ParameterID("POWER", 1), "Power", true);
+    
+    // Auto lets the governor pick the tier from the measured CPU load
+    auto quality = std::make_unique<juce::AudioParameterChoice>(juce::ParameterID("QUALITY", 1), "Quality", juce::StringArray { "Auto", "High", "Medium", "Low" }, 0);
+    juce::NormalisableRange<float> budgetRange(0.01f, 1.0f);
+    budgetRange.setSkewForCentre(DEFAULT_CPU_BUDGET);
+    auto budget = std::make_unique<juce::AudioParameterFloat>(juce::ParameterID("CPUBUDGET", 1), "CPU Budget", budgetRange, DEFAULT_CPU_BUDGET);
+    
+    // Saves the delay memory with the project, for bounces and freezes that
+    // must carry the tail over exactly. Off by default: it can add megabytes
+    // per instance, and processing is suspended while the tail is copied.
+    auto snapshot = std::make_unique<juce::AudioParameterBool>(juce::ParameterID("SNAPSHOT", 1), "Save Delay Buffer", false,
+                                                               juce::AudioParameterBoolAttributes().withAutomatable(false));
+    
+    // Dense, diffuse repeats from a feedback delay network instead of the single line
+    auto network = std::make_unique<juce::AudioParameterChoice>(juce::ParameterID("NETWORK", 1), "Network", juce::StringArray { "Off", "4 Lines", "8 Lines", "16 Lines" }, 0);
+    
+    // Shape the repeats inside the loop; each is off at its default
+    juce::NormalisableRange<float> highCutRange(500.0f, FEEDBACK_HIGH_CUT_OFF_HZ, 1.0f);
+    highCutRange.setSkewForCentre(3000.0f);
+    juce::NormalisableRange<float> lowCutRange(FEEDBACK_LOW_CUT_OFF_HZ, 1000.0f, 1.0f);
+    lowCutRange.setSkewForCentre(150.0f);
+    auto highCut = std::make_unique<juce::AudioParameterFloat>(juce::ParameterID("HIGHCUT", 1), "High Cut", highCutRange, FEEDBACK_HIGH_CUT_OFF_HZ);
+    auto lowCut = std::make_unique<juce::AudioParameterFloat>(juce::ParameterID("LOWCUT", 1), "Low Cut", lowCutRange, FEEDBACK_LOW_CUT_OFF_HZ);
+    auto saturation = std::make_unique<juce::AudioParameterFloat>(juce::ParameterID("SATURATION", 1), "Saturation", juce::NormalisableRange<float>(0.0f, 1.0f), 0.0f);
+    
+    // How the output is kept within full scale, in OutputShape order
+    auto outputShape = std::make_unique<juce::AudioParameterChoice>(juce::ParameterID("OUTPUTSHAPE", 1), "Output Stage", juce::StringArray { "Clip", "Soft", "Tanh" }, 0);
+    
+    params.push_back(std::move(delayTime_ms));
+    params.push_back(std::move(mix));
+    params.push_back(std::move(feedback));
+    params.push_back(std::move(rate));
+    params.push_back(std::move(depth));
+    params.push_back(std::move(power));
+    params.push_back(std::move(quality));
+    params.push_back(std::move(budget));
+    params.push_back(std::move(snapshot));
+    params.push_back(std::move(network));
+    params.push_back(std::move(highCut));
+    params.push_back(std::move(lowCut));
+    params.push_back(std::move(saturation));
+    params.push_back(std::move(outputShape));
+    params.push_back(std::move(timeMode));
+    
+    // Any taps replace the single head, each reading the line at its own
+    // time. A tap's send is how much of it goes back in, scaled by Feedback.
+    params.push_back(std::make_unique<juce::AudioParameterInt>(juce::ParameterID("TAPS", 1), "Taps", 0, MAX_TAPS, 0));
+    for (int tap = 0; tap < MAX_TAPS; ++tap){
+        const juce::String name = "Tap " + juce::String(tap + 1);
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID(getTapParameterID(tap, "TIME"), 1), name + " Time", delayRange, 125.0f * (float) (tap + 1)));
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID(getTapParameterID(tap, "GAIN"), 1), name + " Gain", juce::NormalisableRange<float>(0.0f, 1.0f), 0.5f));
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID(getTapParameterID(tap, "PAN"), 1), name + " Pan", juce::NormalisableRange<float>(-1.0f, 1.0f), 0.0f));
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID(getTapParameterID(tap, "SEND"), 1), name + " Send", juce::NormalisableRange<float>(0.0f, 1.0f), 0.0f));
+    }
+    
+    return {params.begin(), params.end()};
+}
+
+// Called from the audio thread at the start of each block, with every
+// parameter whether it moved or not. The smoothed setters only move a
+// target; the cutoffs and the taps, which cost more to set, skip values
+// that haven't changed.
+template <typename SampleType>
+void ProcrastinatorAudioProcessor::updateParameters(Delay<SampleType>& delay){
+    int delayTime_ms = (int) delayParameter->load();
+    delay.setDelayLength(delayTime_ms);
+    delay.setDelayTimeMode((DelayTimeMode) (int) timeModeParameter->load());
+    
+    float mix = mixParameter->load();
+    delay.setMix(mix);
+    
+    float feedback = feedbackParameter->load();
+    delay.setFeedback(feedback);
+    
+    float rate = rateParameter->load();
+    delay.setRate(rate);
+    
+    int depth = (int) depthParameter->load();
+    delay.setDepth(depth);
+    
+    int network = (int) networkParameter->load();
+    delay.setNetworkSize(network == 0 ? 0 : 2 << network);
+    
+    delay.setHighCut(highCutParameter->load());
+    delay.setLowCut(lowCutParameter->load());
+    delay.setSaturation(saturationParameter->load());
+    delay.setOutputShape((OutputShape) (int) outputShapeParameter->load());
+    
+    const int numTaps = (int) tapsParameter->load();
+    delay.setNumTaps(numTaps);
+    for (int tap = 0; tap < numTaps; ++tap){
+        const std::array<float, 4> settings { tapTimeParameters[tap]->load(), tapGainParameters[tap]->load(),
+                                              tapPanParameters[tap]->load(), tapSendParameters[tap]->load() };
+        if (tap < appliedNumTaps && settings == appliedTaps[(size_t) tap]){
+            continue;
+        }
+        delay.setTap(tap, settings[0], settings[1], settings[2], settings[3]);
+        appliedTaps[(size_t) tap] = settings;
+    }
+    appliedNumTaps = numTaps;
+}
+
+// Reads each parameter's atomic value and counts the ones that moved since
+// the last block, so it stays wait-free on the audio thread
+int ProcrastinatorAudioProcessor::countParameterChanges(){
+    const auto& parameters = getParameters();
+    int numChanged = 0;
+    for (int i = 0; i < parameters.size(); ++i){
+        const float value = parameters.getUnchecked(i)->getValue();
+        if (value != lastParameterValues[(size_t) i]){
+            lastParameterValues[(size_t) i] = value;
+            ++numChanged;
+        }
+    }
+    return numChanged;
+}
+
+template <typename SampleType>
+void ProcrastinatorAudioProcessor::updateQuality(Delay<SampleType>& delay){
+    governor.setBudget(budgetParameter->load());
+    
+    switch ((int) qualityParameter->load()){
+        case 1:  delay.setQuality(DelayQuality::high); break;
+        case 2:  delay.setQuality(DelayQuality::medium); break;
+        case 3:  delay.setQuality(DelayQuality::low); break;
+        default: delay.setQuality(governor.getQuality()); break;
+    }
+}
+
+template <typename SampleType>
+void ProcrastinatorAudioProcessor::updatePower(Delay<SampleType>& delay, bool hostBypassed){
+    isOn = powerParameter->load() > 0.5f;
+    
+    // The delay fades and flushes itself on the audio thread, a slice per block,
+    // where nothing else can be touching the delay line
+    delay.setBypassed(!isOn || hostBypassed);
+}
+
+//==============================================================================
+bool ProcrastinatorAudioProcessor::hasEditor() const
+{
+    return true; // (change this to false if you choose to not supply an editor)
+}
+
+juce::AudioProcessorEditor* ProcrastinatorAudioProcessor::createEditor()
+{
+    return new ProcrastinatorAudioProcessorEditor (*this);
+//    return new juce::GenericAudioProcessorEditor(*this);
+}
+
+//==============================================================================
+// The state is a small binary record rather than the parameter tree's XML:
+// magic, version, then each parameter's ID and plain value, so a project with
+// hundreds of instances restores without building or parsing any XML. IDs
+// rather than positions keep old states loading as parameters are added.
+// An optional GZIP-compressed delay snapshot follows, behind its own size.
+void ProcrastinatorAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
+{
+    juce::MemoryOutputStream stream (destData, false);
+    stream.writeInt(STATE_MAGIC);
+    stream.writeInt(STATE_VERSION);
+    
+    const auto& parameters = getParameters();
+    stream.writeCompressedInt(parameters.size());
+    for (auto* parameter : parameters){
+        auto* rangedParameter = static_cast<juce::RangedAudioParameter*>(parameter);
+        stream.writeString(rangedParameter->getParameterID());
+        stream.writeFloat(rangedParameter->convertFrom0to1(rangedParameter->getValue()));
+    }
+    
+    const bool includeSnapshot = isPrepared && snapshotParameter->load() > 0.5f;
+    stream.writeBool(includeSnapshot);
+    if (!includeSnapshot){
+        return;
+    }
+    
+    juce::MemoryBlock snapshot;
+    {
+        juce::MemoryOutputStream snapshotStream (snapshot, false);
+        if (isUsingDoublePrecision()){
+            captureSnapshot(doubleDelayLine, snapshotStream);
+        }
+        else {
+            captureSnapshot(delayLine, snapshotStream);
+        }
+    }
+    
+    juce::MemoryBlock compressed;
+    {
+        juce::MemoryOutputStream compressedStream (compressed, false);
+        juce::GZIPCompressorOutputStream compressor (compressedStream);
+        compressor.write(snapshot.getData(), snapshot.getSize());
+    }
+    stream.writeInt64((juce::int64) compressed.getSize());
+    stream.write(compressed.getData(), compressed.getSize());
+}
+
+// The buffer is sized before processing is suspended, so the audio only
+// waits for a single pass over the tail, copied here, rather than for
+// the allocation or for blocks to copy it a slice at a time
+template <typename SampleType>
+void ProcrastinatorAudioProcessor::captureSnapshot (Delay<SampleType>& delay, juce::OutputStream& stream)
+{
+    delay.requestSnapshot();
+    
+    suspendProcessing(true);
+    delay.finishSnapshot();
+    suspendProcessing(false);
+    
+    delay.writeSnapshot(stream);
+}
+
+void ProcrastinatorAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
+{
+    juce::MemoryInputStream stream (data, (size_t) sizeInBytes, false);
+    
+    // Anything else, including a state from a newer version, leaves the parameters as they are
+    if (sizeInBytes < 8 || stream.readInt() != STATE_MAGIC){
+        return;
+    }
+    const int version = stream.readInt();
+    if (version > STATE_VERSION){
+        return;
+    }
+    
+    const int numParameters = stream.readCompressedInt();
+    for (int i = 0; i < numParameters && !stream.isExhausted(); ++i){
+        auto parameterID = stream.readString();
+        const float value = stream.readFloat();
+        
+        // Version 1 stored the delay time in ms under its old ID, so the value carries straight over
+        if (version < 2 && parameterID == "DELAYTIME"){
+            parameterID = paramDelay;
+        }
+        if (auto* parameter = treeState.getParameter(parameterID)){
+            parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+        }
+    }
+    
+    if (!stream.readBool()){
+        return;
+    }
+    
+    const auto compressedSize = stream.readInt64();
+    if (compressedSize <= 0 || compressedSize > stream.getNumBytesRemaining()){
+        return;
+    }
+    
+    juce::MemoryInputStream compressedStream (static_cast<const char*>(data) + stream.getPosition(), (size_t) compressedSize, false);
+    juce::GZIPDecompressorInputStream decompressor (compressedStream);
+    pendingSnapshot.reset();
+    decompressor.readIntoMemoryBlock(pendingSnapshot);
+    
+    if (isPrepared){
+        applyPendingSnapshot();
+    }
+}
+
+void ProcrastinatorAudioProcessor::applyPendingSnapshot()
+{
+    if (pendingSnapshot.isEmpty()){
+        return;
+    }
+    
+    // The parameters were restored first and reach the delay on its next
+    // block, where the snapshot snaps them into place
+    juce::MemoryInputStream stream (pendingSnapshot, false);
+    suspendProcessing(true);
+    if (isUsingDoublePrecision()){
+        doubleDelayLine.readSnapshot(stream);
+    }
+    else {
+        delayLine.readSnapshot(stream);
+    }
+    suspendProcessing(false);
+    
+    pendingSnapshot.reset();
+}
+
+void ProcrastinatorAudioProcessor::updateTrackProperties (const TrackProperties& properties)
+{
+    performanceCounters.setLabel(properties.name.value_or(juce::String()));
+}
+
+//==============================================================================
+// This creates new instances of the plugin..
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
+{
+    return new ProcrastinatorAudioProcessor();
+}
@@ -1,81 +1,171 @@
-/*
-  ==============================================================================
-
-    This file contains the basic framework code for a JUCE plugin processor.
-
-  ==============================================================================
-*/
-
-#pragma once
-
-#include <JuceHeader.h>
-#include "Processing/Delay.h"
-
-//==============================================================================
-/**
-*/
-class ProcrastinatorAudioProcessor  : public juce::AudioProcessor, public juce::AudioProcessorValueTreeState::Listener
-{
-public:
-    //==============================================================================
-    ProcrastinatorAudioProcessor();
-    ~ProcrastinatorAudioProcessor() override;
-
-    //==============================================================================
-    void prepareToPlay (double sampleRate, int samplesPerBlock) override;
-    void releaseResources() override;
-
-   #ifndef JucePlugin_PreferredChannelConfigurations
-    bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
-   #endif
-
-    void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
-
-    //==============================================================================
-    juce::AudioProcessorEditor* createEditor() override;
-    bool hasEditor() const override;
-
-    //==============================================================================
-    const juce::String getName() const override;
-
-    bool acceptsMidi() const override;
-    bool producesMidi() const override;
-    bool isMidiEffect() const override;
-    double getTailLengthSeconds() const override;
-
-    //==============================================================================
-    int getNumPrograms() override;
-    int getCurrentProgram() override;
-    void setCurrentProgram (int index) override;
-    const juce::String getProgramName (int index) override;
-    void changeProgramName (int index, const juce::String& newName) override;
-
-    //==============================================================================
-    void getStateInformation (juce::MemoryBlock& destData) override;
-    void setStateInformation (const void* data, int sizeInBytes) override;
-
-    juce::AudioProcessorValueTreeState treeState;
-    
-    juce::String paramDelay    { "DELAYTIME" };
-    juce::String paramMix      { "MIX" };
-    juce::String paramFeedback { "FEEDBACK" };
-    juce::String paramRate     { "RATE" };
-    juce::String paramDepth    { "DEPTH" };
-    juce::String paramPower    { "POWER" };
-    
-private:
-    double lastSampleRate;
-    bool isOn = true;
-    
-    Delay delayLine;
-    
-    void updatePower();
-    
-    juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
-    void parameterChanged(const juce::String& parameterId, float newValue) override;
-    void updateParameters();
-    
-    
-    //==============================================================================
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ProcrastinatorAudioProcessor)
-};
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin processor.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Processing/Delay.h"
+#include "Processing/QualityGovernor.h"
+#include "Processing/SignalFeed.h"
+#include "Diagnostics/PerformanceCounters.h"
+#define MAX_CHANNELS 64
+#define STATE_MAGIC 0x53435250  // "PRCS"
+#define STATE_VERSION 2
+
+//==============================================================================
+/**
+*/
+class ProcrastinatorAudioProcessor  : public juce::AudioProcessor
+{
+public:
+    //==============================================================================
+    ProcrastinatorAudioProcessor();
+    ~ProcrastinatorAudioProcessor() override;
+    
+    //==============================================================================
+    void prepareToPlay (double sampleRate, int samplesPerBlock) override;
+    void releaseResources() override;
+    
+   #ifndef JucePlugin_PreferredChannelConfigurations
+    bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
+   #endif
+    
+    void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    void processBlockBypassed (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlockBypassed (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    bool supportsDoublePrecisionProcessing() const override;
+    
+    //==============================================================================
+    juce::AudioProcessorEditor* createEditor() override;
+    bool hasEditor() const override;
+    
+    //==============================================================================
+    const juce::String getName() const override;
+    
+    bool acceptsMidi() const override;
+    bool producesMidi() const override;
+    bool isMidiEffect() const override;
+    double getTailLengthSeconds() const override;
+    
+    //==============================================================================
+    int getNumPrograms() override;
+    int getCurrentProgram() override;
+    void setCurrentProgram (int index) override;
+    const juce::String getProgramName (int index) override;
+    void changeProgramName (int index, const juce::String& newName) override;
+    
+    //==============================================================================
+    void getStateInformation (juce::MemoryBlock& destData) override;
+    void setStateInformation (const void* data, int sizeInBytes) override;
+    
+    //==============================================================================
+    // Labels this instance in the performance monitor with its track's name
+    void updateTrackProperties (const TrackProperties& properties) override;
+    
+    // The editor records its paint times here
+    PerformanceCounters& getPerformanceCounters() { return performanceCounters; }
+    
+    // Level summaries for the editor's meters and echo view
+    SignalFeed& getSignalFeed() { return signalFeed; }
+    
+    juce::AudioProcessorValueTreeState treeState;
+    
+    juce::String paramDelay    { "DELAYTIME_MS" };
+    juce::String paramMix      { "MIX" };
+    juce::String paramFeedback { "FEEDBACK" };
+    juce::String paramRate     { "RATE" };
+    juce::String paramDepth    { "DEPTH" };
+    juce::String paramPower    { "POWER" };
+    juce::String paramQuality  { "QUALITY" };
+    juce::String paramBudget   { "CPUBUDGET" };
+    juce::String paramSnapshot { "SNAPSHOT" };
+    juce::String paramNetwork  { "NETWORK" };
+    juce::String paramHighCut  { "HIGHCUT" };
+    juce::String paramLowCut   { "LOWCUT" };
+    juce::String paramSaturation { "SATURATION" };
+    juce::String paramOutputShape { "OUTPUTSHAPE" };
+    juce::String paramTimeMode { "TIMEMODE" };
+    juce::String paramTaps     { "TAPS" };
+    
+    // Each tap's fields have their own IDs, e.g. "TAP3GAIN" for the third tap's gain
+    static juce::String getTapParameterID (int tap, const juce::String& field) { return "TAP" + juce::String(tap + 1) + field; }
+
+private:
+    double lastSampleRate;
+    bool isOn = true;
+    bool isPrepared = false;
+    
+    // Only the delay for the host's processing precision is prepared and run
+    Delay<float> delayLine;
+    Delay<double> doubleDelayLine;
+    QualityGovernor governor;
+    PerformanceCounters performanceCounters;
+    SignalFeed signalFeed;
+    
+    // Cached once so the audio thread never looks parameters up by name.
+    // The host and UI write these atomics; processBlock reads them at block start.
+    std::atomic<float>* delayParameter    = nullptr;
+    std::atomic<float>* mixParameter      = nullptr;
+    std::atomic<float>* feedbackParameter = nullptr;
+    std::atomic<float>* rateParameter     = nullptr;
+    std::atomic<float>* depthParameter    = nullptr;
+    std::atomic<float>* powerParameter    = nullptr;
+    std::atomic<float>* qualityParameter  = nullptr;
+    std::atomic<float>* budgetParameter   = nullptr;
+    std::atomic<float>* snapshotParameter = nullptr;
+    std::atomic<float>* networkParameter  = nullptr;
+    std::atomic<float>* highCutParameter  = nullptr;
+    std::atomic<float>* lowCutParameter   = nullptr;
+    std::atomic<float>* saturationParameter = nullptr;
+    std::atomic<float>* outputShapeParameter = nullptr;
+    std::atomic<float>* timeModeParameter = nullptr;
+    std::atomic<float>* tapsParameter     = nullptr;
+    std::atomic<float>* tapTimeParameters[MAX_TAPS] {};
+    std::atomic<float>* tapGainParameters[MAX_TAPS] {};
+    std::atomic<float>* tapPanParameters[MAX_TAPS] {};
+    std::atomic<float>* tapSendParameters[MAX_TAPS] {};
+    
+    // The tap settings last handed to the delay, as setting a tap recomputes
+    // its pan law. Taps from appliedNumTaps up are set afresh when enabled.
+    std::array<std::array<float, 4>, MAX_TAPS> appliedTaps {};
+    int appliedNumTaps = 0;
+    
+    // A decompressed delay snapshot from setStateInformation, held until the
+    // delay is prepared to take it
+    juce::MemoryBlock pendingSnapshot;
+    void applyPendingSnapshot();
+    
+    // Each parameter's normalised value at the last block, for counting changes
+    std::vector<float> lastParameterValues;
+    int countParameterChanges();
+    
+    template <typename SampleType>
+    void prepareDelay (Delay<SampleType>& delay, double sampleRate, int samplesPerBlock);
+    template <typename SampleType>
+    void processBlockWith (juce::AudioBuffer<SampleType>& buffer, Delay<SampleType>& delay);
+    template <typename SampleType>
+    void processBlockBypassedWith (juce::AudioBuffer<SampleType>& buffer, Delay<SampleType>& delay);
+    
+    template <typename SampleType>
+    void updatePower (Delay<SampleType>& delay, bool hostBypassed);
+    template <typename SampleType>
+    void updateQuality (Delay<SampleType>& delay);
+    template <typename SampleType>
+    void processDelay (juce::AudioBuffer<SampleType>& buffer, Delay<SampleType>& delay);
+    
+    juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
+    template <typename SampleType>
+    void updateParameters (Delay<SampleType>& delay);
+    template <typename SampleType>
+    void captureSnapshot (Delay<SampleType>& delay, juce::OutputStream& stream);
+    
+    
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ProcrastinatorAudioProcessor)
+};
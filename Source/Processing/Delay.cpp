@@ -1,206 +1,1542 @@
-/*
-  ==============================================================================
-
-    Delay.cpp
-    Created: 21 Aug 2025 3:35:32pm
-    Author:  Chris
-
-  ==============================================================================
-*/
-
-#include "Delay.h"
-
-void Delay::prepareToPlay(double sampleRate, int samplesPerBlock, int numChannels){
-    lastSampleRate = sampleRate;
-    
-    juce::dsp::ProcessSpec spec;
-    spec.sampleRate = sampleRate;
-    spec.numChannels = numChannels;
-    spec.maximumBlockSize = samplesPerBlock;
-    
-    channelStates.resize(numChannels);
-    for (int channel = 0; channel < numChannels; ++channel){
-        channelStates[channel].channel = channel;
-        channelStates[channel].delayIndex = 0;
-        channelStates[channel].lfo.prepare(spec);
-        channelStates[channel].lfo.initialise([](float x) { return sin(x); });
-        channelStates[channel].lfo.setFrequency(rate.getNextValue());
-    }
-    
-    maxDelayLength = (int)sampleRate;
-
-    delayBuffer.setSize(numChannels, maxDelayLength + 2);
-    delayBuffer.clear();
-    
-    isPrepared = true;
-    
-    reset();
-}
-
-void Delay::reset(){
-    
-    mix = DEFAULT_MIX;
-    feedback = DEFAULT_FEEDBACK;
-    rate = DEFAULT_RATE;
-    depth = DEFAULT_DEPTH;
-    
-    dryGain.reset(lastSampleRate, 0.02);
-    wetGain.reset(lastSampleRate, 0.02);
-    feedback.reset(lastSampleRate, 0.02);
-    rate.reset(lastSampleRate, 0.02);
-    
-    centerDelayLength = (int) lastSampleRate / 2;
-    delayLength.reset(lastSampleRate, 0.02);
-    delayBuffer.clear();
-    
-    for (int channel = 0; channel < channelStates.size(); ++channel){
-        channelStates[channel].delayIndex = 0;
-        channelStates[channel].lfo.reset();
-    }
-    
-}
-
-float Delay::processSample(int channel, float input){
-    
-    jassert (isPrepared);
-    
-    ChannelState* channelState = &channelStates[channel];
-    
-    float delayOutput = readFromBuffer(channelState);
-    writeToBuffer(channelState, input);
-    
-    float lfoValue = channelState->lfo.processSample(0.0f);
-    float modulationLength = lfoValue * convertMStoSample(depth);
-
-    delayLength.setTargetValue(limitDelayLength(centerDelayLength + modulationLength));
-    
-    channelState->delayIndex++;
-    if (channelState->delayIndex >= delayLength.getNextValue()){
-        channelState->delayIndex -= delayLength.getNextValue();
-    }
-
-    // Balanced Dry/Wet Mixing Rule
-    dryGain.setTargetValue(2.0f * juce::jmin(0.5f, 1.0f - mix));
-    wetGain.setTargetValue(2.0f * juce::jmin(0.5f, mix));
-    float output = dryGain.getNextValue() * input + wetGain.getNextValue() * delayOutput;
-    
-    return limitOutput(output);
-}
-
-float Delay::readFromBuffer(ChannelState* channelState){
-
-//    return interpolateSample(channelState);
-    return delayBuffer.getSample(channelState->channel, channelState->delayIndex);
-}
-
-void Delay::writeToBuffer(ChannelState* channelState, float input){
-    float delayOutput = readFromBuffer(channelState);
-    float delayInput = input + delayOutput * feedback.getNextValue();
-    delayBuffer.setSample(channelState->channel, channelState->delayIndex, delayInput);
-}
-
-float Delay::interpolateSample(ChannelState* channelState){
-    size_t index1 = static_cast<size_t> (std::floor (channelState->delayIndex));
-    size_t index2 = index1 + 1;
-    
-    if (index2 >= maxDelayLength){
-        index1 %= maxDelayLength;
-        index2 %= maxDelayLength;
-    }
-    
-    auto value1 = delayBuffer.getSample (channelState->channel, index1);
-    auto value2 = delayBuffer.getSample (channelState->channel, index2);
-
-    return value1 + (channelState->delayIndex - 1) * (value2 - value1);
-}
-
-void Delay::setDelayLength(const int delayTime_ms){
-    
-    jassert(isPrepared);
-    jassert(delayTime_ms > 0);
-    
-    centerDelayLength = convertMStoSample(delayTime_ms);
-    
-    if (centerDelayLength > maxDelayLength){
-        centerDelayLength = maxDelayLength;
-    }
-}
-
-void Delay::setMix(const float newValue){
-    
-    jassert(isPrepared);
-    
-    this->mix = newValue;
-}
-
-void Delay::setFeedback(const float newValue){
-    
-    jassert(isPrepared);
-    
-    this->feedback.setTargetValue(newValue);
-}
-
-void Delay::setRate(const float newValue){
-    
-    jassert(isPrepared);
-    
-    this->rate.setTargetValue(newValue);
-    
-    for (int channel = 0; channel < channelStates.size(); channel++){
-        channelStates[channel].lfo.setFrequency(rate.getNextValue());
-    }
-    
-}
-
-void Delay::setDepth(const int depth){
-    
-    jassert(isPrepared);
-    
-    this->depth = depth;
-}
-
-void Delay::clearDelayLine(){
-    delayBuffer.clear();
-}
-
-//-----------------------------------------------------------------------------
-// Utility
-//-----------------------------------------------------------------------------
-int Delay::convertMStoSample(const int time){
-    return (unsigned int) (0.001f * time * lastSampleRate);
-}
-
-float Delay::lerp(float a, float b, float f)
-{
-    return a * (1.0 - f) + (b * f);
-}
-
-int Delay::limitDelayLength(int delayLength){
-    
-    int result = delayLength;
-    if (delayLength < 0){
-        result = convertMStoSample(1);
-    }
-    if (delayLength >= maxDelayLength){
-        result = maxDelayLength;
-    }
-    return result;
-}
-
-float Delay::limitOutput(float value){
-    
-    float output = 0.0f;
-    
-    if (value > 1.0f){
-        output = 1.0f;
-    }
-    else if (value < -1.0f){
-        output = -1.0f;
-    }
-    else {
-        output = value;
-    }
-    
-    return output;
-}
-
+/*
+  ==============================================================================
+
+    Delay.cpp
+    Created: 21 Aug 2025 3:35:32pm
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#include "Delay.h"
+
+template <typename SampleType>
+void Delay<SampleType>::prepareToPlay(double sampleRate, int samplesPerBlock, int numChannels, DelayBufferLayout layout, DelayInterpolation interpolationType){
+    lastSampleRate = sampleRate;
+    bufferLayout = layout;
+    interpolation = interpolationType;
+    
+    channelStates.resize(numChannels);
+    for (int channel = 0; channel < numChannels; ++channel){
+        channelStates[channel].channel = channel;
+    }
+    
+    lfo.setFrequency(rate.getTargetValue());
+    lfo.prepare(sampleRate, samplesPerBlock, numChannels);
+    tapTable.prepare(sampleRate, numChannels);
+    feedbackChain.prepare(numChannels);
+    networkChain.prepare(FDN_MAX_LINES);
+    outputStage.prepare(numChannels, samplesPerBlock);
+    highCutFrequency = -1.0f;
+    lowCutFrequency = -1.0f;
+    
+    feedbackRamp.prepare(samplesPerBlock);
+    dryRamp.prepare(samplesPerBlock);
+    wetRamp.prepare(samplesPerBlock);
+    delayedBlock.setSize(numChannels, samplesPerBlock);
+    fadeBlock.setSize(numChannels, samplesPerBlock);
+    fadeLength = juce::jmax(1, (int) (sampleRate * QUALITY_FADE_SECONDS));
+    dryBlock.setSize(numChannels, samplesPerBlock);
+    bypassGains.setSize(2, samplesPerBlock);
+    bypassFadeLength = juce::jmax(1, (int) (sampleRate * BYPASS_FADE_SECONDS));
+    
+    delayLength.resize(1);
+    minimumGlideLength = juce::jmax(1, (int) (sampleRate * TAPE_MIN_GLIDE_SECONDS));
+    maximumGlideLength = juce::jmax(minimumGlideLength, (int) (sampleRate * TAPE_MAX_GLIDE_SECONDS));
+    jumpFadeLength = juce::jmax(1, (int) (sampleRate * JUMP_FADE_SECONDS));
+    
+    maxDelayLength = (int) (sampleRate * (longDelayMode ? MAX_LONG_DELAY_SECONDS : MAX_DELAY_SECONDS));
+    maxBlockSize = samplesPerBlock;
+    
+    // Round the ring up to a power of two so wrapping is a single mask,
+    // leaving room for the interpolator's taps past the longest delay
+    const int bufferSize = juce::nextPowerOfTwo(maxDelayLength + 3);
+    delayMemory.prepare(bufferSize, numChannels, bufferLayout, longDelayMode);
+    network.prepare(sampleRate, samplesPerBlock, juce::jmin(maxDelayLength, (int) (sampleRate * FDN_MAX_DELAY_SECONDS)));
+    
+    if (bufferLayout == DelayBufferLayout::interleaved){
+        // Pad each frame up to a whole number of registers; the spare lanes stay silent
+        registersPerFrame = (numChannels + (int) SIMDSample::SIMDNumElements - 1) / (int) SIMDSample::SIMDNumElements;
+        interleavedBlock.assign((size_t) samplesPerBlock * registersPerFrame, SIMDSample::expand(0.0f));
+        interleavedInterpolatorState.assign((size_t) registersPerFrame, SIMDSample::expand(0.0f));
+        interleavedOutgoingState.assign((size_t) registersPerFrame, SIMDSample::expand(0.0f));
+        interleavedReadFrame.assign((size_t) registersPerFrame, SIMDSample::expand(0.0f));
+        interleavedFeedbackFrame.assign((size_t) registersPerFrame, SIMDSample::expand(0.0f));
+        interleavedTapGains.assign((size_t) (2 * MAX_TAPS * registersPerFrame), SIMDSample::expand(0.0f));
+        interleavedTapStates.assign((size_t) (MAX_TAPS * registersPerFrame), SIMDSample::expand(0.0f));
+    }
+    else {
+        registersPerFrame = 0;
+        interleavedBlock.clear();
+        interleavedInterpolatorState.clear();
+        interleavedOutgoingState.clear();
+        interleavedReadFrame.clear();
+        interleavedFeedbackFrame.clear();
+        interleavedTapGains.clear();
+        interleavedTapStates.clear();
+    }
+    
+    prepareGroups(numChannels);
+    
+    isPrepared = true;
+    
+    applyQuality();
+    
+    reset();
+}
+
+template <typename SampleType>
+void Delay<SampleType>::prepareGroups(int numChannels){
+    
+    if (bufferLayout == DelayBufferLayout::interleaved){
+        // Groups span whole cache lines of a frame, so no two write the same line
+        const int registersPerLine = juce::jmax(1, 64 / (int) sizeof(SIMDSample));
+        groupSize = juce::jmax(registersPerLine, CHANNELS_PER_GROUP / (int) SIMDSample::SIMDNumElements);
+        numGroups = (registersPerFrame + groupSize - 1) / groupSize;
+    }
+    else {
+        groupSize = CHANNELS_PER_GROUP;
+        numGroups = (numChannels + groupSize - 1) / groupSize;
+    }
+    numGroups = juce::jmax(1, numGroups);
+    
+    // Workers are spawned here, never on the audio thread
+    int numWorkers = 0;
+    if (parallelGroups && numChannels >= MIN_PARALLEL_CHANNELS){
+        numWorkers = juce::jmin(numGroups - 1, juce::SystemStats::getNumCpus() - 1);
+    }
+    
+    if (numWorkers <= 0){
+        pool.reset();
+    }
+    else if (pool == nullptr || pool->getNumWorkers() != numWorkers){
+        pool = std::make_unique<WorkStealingPool>(numWorkers);
+    }
+    
+    groupPeaks.assign((size_t) numGroups, 0.0f);
+    groupTask = [this](int group){ (this->*groupKernel)(*currentBlock, currentIsModulating, group); };
+}
+
+template <typename SampleType>
+void Delay<SampleType>::reset(){
+    
+    mix = DEFAULT_MIX;
+    feedback = DEFAULT_FEEDBACK;
+    rate = DEFAULT_RATE;
+    depth = DEFAULT_DEPTH;
+    
+    dryGain.reset(lastSampleRate, 0.02);
+    wetGain.reset(lastSampleRate, 0.02);
+    feedback.reset(lastSampleRate, 0.02);
+    rate.reset(lastSampleRate, 0.02);
+    
+    // The head starts at its first time after a reset rather than gliding to it
+    centerDelayLength = (float) lastSampleRate / 2;
+    delayLength.snap();
+    delayLength.unset();
+    jumpRemaining = 0;
+    clearDelayLine();
+    network.reset();
+    network.setDelayLength(centerDelayLength);
+    
+    writePosition = 0;
+    lfo.reset();
+    for (int channel = 0; channel < channelStates.size(); ++channel){
+        channelStates[channel].interpolatorState = 0.0f;
+        channelStates[channel].outgoingState = 0.0f;
+        channelStates[channel].needsReset = false;
+    }
+    outputStage.reset();
+    std::fill(interleavedInterpolatorState.begin(), interleavedInterpolatorState.end(), SIMDSample::expand(0.0f));
+    std::fill(interleavedOutgoingState.begin(), interleavedOutgoingState.end(), SIMDSample::expand(0.0f));
+    
+    tapTable.reset();
+    std::fill(interleavedTapStates.begin(), interleavedTapStates.end(), SIMDSample::expand(0.0f));
+    
+    fadeRemaining = 0;
+    fadingNetworkSize = networkSize;
+    sleeping = false;
+    hasSkipped = false;
+    
+    bypassFadePosition = bypassed ? bypassFadeLength : 0;
+    lineFlushing = false;
+    networkFlushing = false;
+    
+    // A capture under way restarts from the new state
+    int capturing = snapshotCapturing;
+    snapshotState.compare_exchange_strong(capturing, snapshotRequested);
+}
+
+template <typename SampleType>
+void Delay<SampleType>::process(const juce::dsp::ProcessContextReplacing<SampleType>& context){
+    
+    jassert (isPrepared);
+    
+    if (context.isBypassed){
+        return;
+    }
+    
+    auto& block = context.getOutputBlock();
+    
+    // Flushes carry on whatever else happens, and coming back before one is
+    // done leaves the reads masking what it has still to clear
+    continueEngineFlushes(fadeRemaining > 0);
+    continueFlushes();
+    continueSnapshot((int) block.getNumSamples());
+    
+    // Fully bypassed costs a slice of the flush and nothing per sample
+    if (bypassed && !isBypassFading()){
+        return;
+    }
+    
+    // Targets only change between blocks, so they are set once here rather than per sample
+    retargetHead();
+    
+    // Balanced Dry/Wet Mixing Rule
+    dryGain.setTargetValue(2.0f * juce::jmin(0.5f, 1.0f - mix));
+    wetGain.setTargetValue(2.0f * juce::jmin(0.5f, mix));
+    
+    if (snapToTargets){
+        snapSmoothers();
+    }
+    
+    // In long delay mode the memory only keeps what the reads can reach,
+    // and what a snapshot has still to copy
+    int reach = getReadReach();
+    lastReadReach.store(reach, std::memory_order_relaxed);
+    if (snapshotState.load(std::memory_order_relaxed) == snapshotCapturing){
+        reach = juce::jmax(reach, (int) (writePosition - snapshotPosition) + snapshotLength - snapshotCopied.load(std::memory_order_relaxed));
+    }
+    delayMemory.setReach(reach);
+    
+    // The LFO runs at block rate, so its frequency only needs updating here
+    if (rate.isSmoothing()){
+        lfo.setFrequency(rate.skip((int) block.getNumSamples()));
+    }
+    
+    const bool inputIsSilent = getPeak(block) < SILENCE_THRESHOLD;
+    // A parameter change may reach further back than the quiet history, or
+    // start a fade, which wakes the delay to process it
+    if (sleeping && inputIsSilent && !isBypassFading() && fadeRemaining == 0 && quietFrames >= getQuietReach()){
+        skipBlock((int) block.getNumSamples());
+        return;
+    }
+    
+    // Nothing was written while asleep, so frames older than the quiet run
+    // would come back early if a longer read reached them. They are flushed
+    // instead, as lazy memory drops whatever is beyond the reach anyway. A
+    // flush under way already hides older frames, so that takes the whole line.
+    if (hasSkipped && quietFrames < getRingReach()){
+        const juce::uint32 quietStart = writePosition - (juce::uint32) quietFrames;
+        delayMemory.startFlush(delayMemory.isFlushing() ? writePosition : quietStart);
+        network.startFlush(network.isFlushing() ? writePosition : quietStart);
+    }
+    hasSkipped = false;
+    
+    const bool isModulating = depth > 0;
+    
+    // Input above the threshold reaches the memory, so written peaks are only
+    // worth measuring while the input is silent and the line may be dying away
+    measuringPeaks = inputIsSilent;
+    
+    // The LFO and interleaving scratch buffers hold at most one prepared block
+    for (size_t start = 0; start < block.getNumSamples(); start += (size_t) maxBlockSize){
+        auto subBlock = block.getSubBlock(start, juce::jmin((size_t) maxBlockSize, block.getNumSamples() - start));
+        const int numSamples = (int) subBlock.getNumSamples();
+        
+        if (isModulating){
+            lfo.process(numSamples);
+        }
+        else {
+            lfo.skip(numSamples);
+        }
+        
+        // Each memory is only written while an engine using it runs
+        const bool isFading = fadeRemaining > 0;
+        if (networkSize == 0 || (isFading && fadingNetworkSize == 0)){
+            delayMemory.prepareToWrite(writePosition, numSamples);
+        }
+        if (networkSize > 0 || (isFading && fadingNetworkSize > 0)){
+            network.prepareToWrite(writePosition, numSamples);
+        }
+        delayLength.advance(1, numSamples);
+        tapTable.advance(numSamples);
+        network.advance(numSamples);
+        
+        feedbackRamp.render(feedback, numSamples, controlInterval);
+        dryRamp.render(dryGain, numSamples);
+        wetRamp.render(wetGain, numSamples);
+        
+        if (bufferLayout == DelayBufferLayout::interleaved && tapTable.getNumTaps() > 0){
+            updateInterleavedTapGains();
+        }
+        
+        // While the interpolator or the network size changes, the block is
+        // also run through the outgoing engine into the fade scratch. Where it
+        // writes the same slots as the incoming pass, that pass simply
+        // overwrites them.
+        const bool isBypassing = isBypassFading();
+        if (isBypassing){
+            for (size_t channel = 0; channel < subBlock.getNumChannels(); ++channel){
+                dryBlock.copyFrom((int) channel, 0, subBlock.getChannelPointer(channel), numSamples);
+            }
+        }
+        
+        if (isFading){
+            auto fadeSubBlock = juce::dsp::AudioBlock<SampleType>(fadeBlock).getSubsetChannelBlock(0, subBlock.getNumChannels())
+                                                                       .getSubBlock(0, (size_t) numSamples);
+            fadeSubBlock.copyFrom(subBlock);
+            
+            feedbackChain.saveStates();
+            networkChain.saveStates();
+            outputStage.saveStates();
+            runEngine(fadeSubBlock, fadingInterpolation, fadingNetworkSize, isModulating);
+            feedbackChain.restoreStates();
+            networkChain.restoreStates();
+            outputStage.restoreStates();
+        }
+        
+        runEngine(subBlock, activeInterpolation, networkSize, isModulating);
+        jumpRemaining = juce::jmax(0, jumpRemaining - numSamples);
+        
+        if (isFading){
+            crossfade(subBlock);
+        }
+        
+        resetBrokenChannels(numSamples);
+        
+        if (isBypassing){
+            mixBypass(subBlock);
+        }
+        
+        updateQuietFrames(numSamples);
+        writePosition += (juce::uint32) numSamples;
+    }
+    
+    // Only once every frame the reads can reach is quiet, however long the
+    // feedback took to die away; with the network in use, its lines count too
+    sleeping = inputIsSilent && quietFrames >= getQuietReach();
+    
+    // The fade to bypass has just finished, so the memory is no longer read
+    // and nothing written so far is to be heard again
+    if (bypassed && !isBypassFading()){
+        delayMemory.startFlush(writePosition);
+        network.startFlush(writePosition);
+        lineFlushing = false;
+        networkFlushing = false;
+        
+        feedbackChain.reset();
+        networkChain.reset();
+        outputStage.reset();
+        quietFrames = getRingReach();
+    }
+}
+
+// The longest delay plus the interpolators' two frames past it
+template <typename SampleType>
+int Delay<SampleType>::getRingReach(){
+    return maxDelayLength + 3;
+}
+
+// The furthest back this block can read: the head anywhere along its glide,
+// the outgoing head of a jump, every tap, and the modulation on top
+template <typename SampleType>
+int Delay<SampleType>::getReadReach(){
+    
+    float longest = juce::jmax(delayLength.getCurrent(0), delayLength.getTarget(0), tapTable.getLongestDelay());
+    if (jumpRemaining > 0){
+        longest = juce::jmax(longest, outgoingLength);
+    }
+    longest += convertMStoSample((float) depth);
+    
+    return juce::jmin((int) std::ceil(longest), maxDelayLength) + 3;
+}
+
+// How far back the head, the taps or, while it runs, the network read
+template <typename SampleType>
+int Delay<SampleType>::getQuietReach(){
+    int reach = getReadReach();
+    if (networkSize > 0 || (fadeRemaining > 0 && fadingNetworkSize > 0)){
+        reach = juce::jmax(reach, (int) std::ceil(network.getLongestDelay()) + 3);
+    }
+    return reach;
+}
+
+template <typename SampleType>
+void Delay<SampleType>::updateQuietFrames(int numSamples){
+    
+    if (!measuringPeaks){
+        quietFrames = 0;
+        return;
+    }
+    
+    SampleType writtenPeak = 0;
+    for (int group = 0; group < numGroups; ++group){
+        writtenPeak = juce::jmax(writtenPeak, groupPeaks[(size_t) group]);
+    }
+    
+    if (writtenPeak < SILENCE_THRESHOLD){
+        quietFrames = juce::jmin(quietFrames + numSamples, getRingReach());
+    }
+    else {
+        quietFrames = 0;
+    }
+}
+
+// Nothing is written while asleep, so the memory keeps its quiet history;
+// only the parameters and the LFO move on
+template <typename SampleType>
+void Delay<SampleType>::skipBlock(int numSamples){
+    hasSkipped = true;
+    lfo.skip(numSamples);
+    delayLength.advance(1, numSamples);
+    tapTable.advance(numSamples);
+    network.advance(numSamples);
+    
+    feedback.skip(numSamples);
+    dryGain.skip(numSamples);
+    wetGain.skip(numSamples);
+    
+    fadeRemaining = juce::jmax(0, fadeRemaining - numSamples);
+    jumpRemaining = juce::jmax(0, jumpRemaining - numSamples);
+}
+
+template <typename SampleType>
+void Delay<SampleType>::runGroups(juce::dsp::AudioBlock<SampleType>& block, GroupKernel kernel, bool isModulating){
+    
+    // Groups share nothing but read-only block state, so they can go to the
+    // pool. Waking the workers costs more than a small block's work, which
+    // then runs inline.
+    groupKernel = kernel;
+    currentBlock = &block;
+    currentIsModulating = isModulating;
+    
+    const size_t numSamples = block.getNumSamples() * block.getNumChannels();
+    if (pool != nullptr && numSamples >= MIN_PARALLEL_SAMPLES){
+        pool->run(numGroups, groupTask);
+    }
+    else {
+        for (int group = 0; group < numGroups; ++group){
+            (this->*groupKernel)(block, isModulating, group);
+        }
+    }
+    
+    currentBlock = nullptr;
+}
+
+template <typename SampleType>
+void Delay<SampleType>::runEngine(juce::dsp::AudioBlock<SampleType>& block, DelayInterpolation type, int numLines, bool isModulating){
+    if (numLines > 0){
+        processNetwork(block, numLines);
+    }
+    else {
+        runGroups(block, selectKernel(type), isModulating);
+    }
+}
+
+template <typename SampleType>
+void Delay<SampleType>::processNetwork(juce::dsp::AudioBlock<SampleType>& block, int numLines){
+    
+    const int numSamples = (int) block.getNumSamples();
+    const SampleType writtenPeak = network.process(block, delayedBlock, numLines, writePosition, feedbackRamp, networkChain);
+    
+    for (size_t channel = 0; channel < block.getNumChannels(); ++channel){
+        SampleType* channelData = block.getChannelPointer(channel);
+        dryRamp.multiply(channelData, numSamples);
+        wetRamp.addWithMultiply(channelData, delayedBlock.getReadPointer((int) channel), numSamples);
+        shapeOutput(channelData, numSamples, (int) channel);
+    }
+    
+    // The lines mix into each other, so the network is one group
+    std::fill(groupPeaks.begin(), groupPeaks.end(), (SampleType) 0);
+    groupPeaks[0] = writtenPeak;
+}
+
+// The memory neither engine is using is flushed, but not while the engine
+// fading out still reads it
+template <typename SampleType>
+void Delay<SampleType>::continueEngineFlushes(bool isFading){
+    if (lineFlushing && !(isFading && fadingNetworkSize == 0)){
+        delayMemory.startFlush(writePosition);
+        lineFlushing = false;
+    }
+    if (networkFlushing && !(isFading && fadingNetworkSize > 0)){
+        network.startFlush(writePosition);
+        networkFlushing = false;
+    }
+}
+
+template <typename SampleType>
+void Delay<SampleType>::continueFlushes(){
+    delayMemory.continueFlush(writePosition, juce::jmax(FLUSH_SAMPLES_PER_BLOCK, delayMemory.getNumSamples() / FLUSH_BLOCKS));
+    network.continueFlush(writePosition, juce::jmax(FLUSH_SAMPLES_PER_BLOCK, network.getMemorySize() / FLUSH_BLOCKS));
+}
+
+template <typename SampleType>
+typename Delay<SampleType>::GroupKernel Delay<SampleType>::selectKernel(DelayInterpolation type){
+    switch (type){
+        case DelayInterpolation::cubicHermite: return kernelFor<Interpolation::CubicHermite>();
+        case DelayInterpolation::lagrange3:    return kernelFor<Interpolation::Lagrange3>();
+        case DelayInterpolation::thiran:       return kernelFor<Interpolation::Thiran>();
+        case DelayInterpolation::linear:
+        default:                               return kernelFor<Interpolation::Linear>();
+    }
+}
+
+template <typename SampleType>
+template <typename Interpolator>
+typename Delay<SampleType>::GroupKernel Delay<SampleType>::kernelFor(){
+    const bool isMasked = delayMemory.isFlushing();
+    if (bufferLayout == DelayBufferLayout::interleaved){
+        return isMasked ? &Delay::template processInterleaved<Interpolator, true>
+                        : &Delay::template processInterleaved<Interpolator, false>;
+    }
+    if (delayMemory.isContiguous()){
+        return isMasked ? &Delay::template processPlanar<Interpolator, true, true>
+                        : &Delay::template processPlanar<Interpolator, true, false>;
+    }
+    return isMasked ? &Delay::template processPlanar<Interpolator, false, true>
+                    : &Delay::template processPlanar<Interpolator, false, false>;
+}
+
+// Fades the block from the outgoing interpolator's output in the fade scratch to its own
+template <typename SampleType>
+void Delay<SampleType>::crossfade(juce::dsp::AudioBlock<SampleType>& block){
+    
+    const int numSamples = (int) block.getNumSamples();
+    const int faded = fadeLength - fadeRemaining;
+    
+    for (size_t channel = 0; channel < block.getNumChannels(); ++channel){
+        SampleType* channelData = block.getChannelPointer(channel);
+        const SampleType* fadeData = fadeBlock.getReadPointer((int) channel);
+        
+        for (int sample = 0; sample < numSamples; ++sample){
+            const float gain = juce::jmin(1.0f, (float) (faded + sample + 1) / (float) fadeLength);
+            channelData[sample] = fadeData[sample] + (channelData[sample] - fadeData[sample]) * gain;
+        }
+    }
+    
+    fadeRemaining = juce::jmax(0, fadeRemaining - numSamples);
+}
+
+template <typename SampleType>
+template <typename Interpolator, bool isContiguous, bool isMasked>
+void Delay<SampleType>::processPlanar(juce::dsp::AudioBlock<SampleType>& block, bool isModulating, int group){
+    
+    const int numChannels = juce::jmin((int) block.getNumChannels(), (int) channelStates.size());
+    const int lastChannel = juce::jmin(numChannels, (group + 1) * groupSize);
+    const int numSamples = (int) block.getNumSamples();
+    const float depthSamples = convertMStoSample((float) depth);
+    const float headStart = delayLength.getStart()[0];
+    const float headIncrement = delayLength.getIncrement()[0];
+    const bool isJumping = jumpRemaining > 0;
+    
+    SampleType writtenPeak = 0;
+    
+    // The ramps were rendered once for the whole block, so the channels can be
+    // processed one after another, or side by side, and still see identical
+    // parameter values.
+    for (int channel = group * groupSize; channel < lastChannel; ++channel){
+        
+        ChannelState<SampleType>* channelState = &channelStates[channel];
+        SampleType* delayed = delayedBlock.getWritePointer(channel);
+        SampleType* channelData = block.getChannelPointer(channel);
+        const float* modulationBlock = lfo.getChannelBlock(channel);
+        
+        // The read/write recursion is inherently serial in time...
+        if (tapTable.getNumTaps() > 0){
+            for (int sample = 0; sample < numSamples; ++sample){
+                const juce::uint32 position = writePosition + (juce::uint32) sample;
+                
+                float modulation = isModulating ? modulationBlock[sample] * depthSamples : 0.0f;
+                SampleType feedbackSum = 0;
+                
+                delayed[sample] = readTaps<Interpolator, isContiguous, isMasked>(channel, position, sample, modulation, feedbackSum);
+                const SampleType written = writeToBuffer<isContiguous>(channel, position, channelData[sample], feedbackSum, feedbackRamp[sample]);
+                if (measuringPeaks){
+                    writtenPeak = juce::jmax(writtenPeak, std::abs(written));
+                }
+            }
+        }
+        else if (isJumping){
+            // Mid-jump the outgoing head is read too, and fades out under the new one
+            for (int sample = 0; sample < numSamples; ++sample){
+                const juce::uint32 position = writePosition + (juce::uint32) sample;
+                
+                float modulation = isModulating ? modulationBlock[sample] * depthSamples : 0.0f;
+                float modulatedLength = limitDelayLength(headStart + headIncrement * (float) sample + modulation, Interpolator::minimumDelay);
+                float outgoingModulated = limitDelayLength(outgoingLength + modulation, Interpolator::minimumDelay);
+                
+                const SampleType incoming = readFromBuffer<Interpolator, isContiguous, isMasked>(channel, position, modulatedLength, channelState->interpolatorState);
+                const SampleType outgoing = readFromBuffer<Interpolator, isContiguous, isMasked>(channel, position, outgoingModulated, channelState->outgoingState);
+                delayed[sample] = outgoing + (incoming - outgoing) * getJumpGain(sample);
+                
+                const SampleType written = writeToBuffer<isContiguous>(channel, position, channelData[sample], delayed[sample], feedbackRamp[sample]);
+                if (measuringPeaks){
+                    writtenPeak = juce::jmax(writtenPeak, std::abs(written));
+                }
+            }
+        }
+        else {
+            for (int sample = 0; sample < numSamples; ++sample){
+                const juce::uint32 position = writePosition + (juce::uint32) sample;
+                
+                float modulation = isModulating ? modulationBlock[sample] * depthSamples : 0.0f;
+                float modulatedLength = limitDelayLength(headStart + headIncrement * (float) sample + modulation, Interpolator::minimumDelay);
+                
+                delayed[sample] = readFromBuffer<Interpolator, isContiguous, isMasked>(channel, position, modulatedLength, channelState->interpolatorState);
+                const SampleType written = writeToBuffer<isContiguous>(channel, position, channelData[sample], delayed[sample], feedbackRamp[sample]);
+                
+                // The feedback path's filters carry state between blocks, so
+                // the block's peaks no longer bound what was written
+                if (measuringPeaks){
+                    writtenPeak = juce::jmax(writtenPeak, std::abs(written));
+                }
+            }
+        }
+        
+        // ...but the balanced dry/wet mix and the output stage are whole-block vector operations
+        dryRamp.multiply(channelData, numSamples);
+        wetRamp.addWithMultiply(channelData, delayed, numSamples);
+        shapeOutput(channelData, numSamples, channel);
+    }
+    
+    groupPeaks[(size_t) group] = writtenPeak;
+}
+
+template <typename SampleType>
+template <typename Interpolator, bool isMasked>
+void Delay<SampleType>::processInterleaved(juce::dsp::AudioBlock<SampleType>& block, bool isModulating, int group){
+    
+    const int numSamples = (int) block.getNumSamples();
+    const float depthSamples = convertMStoSample((float) depth);
+    const int frameStride = registersPerFrame * (int) SIMDSample::SIMDNumElements;
+    
+    // A group owns whole registers, and the channels in their lanes
+    const int firstRegister = group * groupSize;
+    const int lastRegister = juce::jmin(registersPerFrame, firstRegister + groupSize);
+    const int firstChannel = firstRegister * (int) SIMDSample::SIMDNumElements;
+    const int lastChannel = juce::jmin(juce::jmin((int) block.getNumChannels(), (int) channelStates.size()),
+                                       lastRegister * (int) SIMDSample::SIMDNumElements);
+    
+    SampleType* interleavedData = reinterpret_cast<SampleType*>(interleavedBlock.data());
+    
+    for (int channel = firstChannel; channel < lastChannel; ++channel){
+        const SampleType* channelData = block.getChannelPointer(channel);
+        for (int sample = 0; sample < numSamples; ++sample){
+            interleavedData[sample * frameStride + channel] = channelData[sample];
+        }
+    }
+    
+    // Unless the LFO has per-channel phase offsets, every channel shares one read
+    // and one write position, so a whole frame is read, fed back, written and
+    // mixed as register-wide operations. With offsets the reads are gathered
+    // lane by lane and everything after the read stays register-wide.
+    const bool lanesShareDelay = !isModulating || !lfo.hasPhaseOffsets();
+    
+    SampleType* laneStates = reinterpret_cast<SampleType*>(interleavedInterpolatorState.data());
+    SampleType* outgoingLaneStates = reinterpret_cast<SampleType*>(interleavedOutgoingState.data());
+    SampleType* gatheredFrame = reinterpret_cast<SampleType*>(interleavedReadFrame.data());
+    
+    // In multi-tap mode the frame read is the sum of every tap's panned output,
+    // and the feedback path gets its own sum of the taps' sends
+    const int numTaps = tapTable.getNumTaps();
+    const bool isMultiTap = numTaps > 0;
+    SampleType* tapLaneStates = reinterpret_cast<SampleType*>(interleavedTapStates.data());
+    SampleType* gatheredFeedback = reinterpret_cast<SampleType*>(interleavedFeedbackFrame.data());
+    const SIMDSample* feedbackFrame = isMultiTap ? interleavedFeedbackFrame.data() : interleavedReadFrame.data();
+    
+    const SIMDSample* tapGainStarts = interleavedTapGains.data();
+    const SIMDSample* tapGainIncrements = interleavedTapGains.data() + MAX_TAPS * registersPerFrame;
+    const float* tapDelayStart = tapTable.getDelayStart();
+    const float* tapDelayIncrement = tapTable.getDelayIncrement();
+    const float* tapSendStart = tapTable.getSendStart();
+    const float* tapSendIncrement = tapTable.getSendIncrement();
+    
+    const float headStart = delayLength.getStart()[0];
+    const float headIncrement = delayLength.getIncrement()[0];
+    const bool isJumping = jumpRemaining > 0;
+    
+    SIMDSample writtenPeak = SIMDSample::expand(0.0f);
+    
+    for (int sample = 0; sample < numSamples; ++sample){
+        
+        const juce::uint32 position = writePosition + (juce::uint32) sample;
+        const float currentDelayLength = headStart + headIncrement * (float) sample;
+        const SampleType currentFeedback = feedbackRamp[sample];
+        const SampleType currentDryGain = dryRamp[sample];
+        const SampleType currentWetGain = wetRamp[sample];
+        
+        SIMDSample* inputFrame = &interleavedBlock[(size_t) sample * registersPerFrame];
+        SIMDSample* writeFrame = reinterpret_cast<SIMDSample*>(delayMemory.getWriteFrame(position));
+        
+        if (isMultiTap && lanesShareDelay){
+            float modulation = isModulating ? lfo.getChannelBlock(0)[sample] * depthSamples : 0.0f;
+            
+            for (int reg = firstRegister; reg < lastRegister; ++reg){
+                interleavedReadFrame[reg] = SIMDSample::expand(0.0f);
+                interleavedFeedbackFrame[reg] = SIMDSample::expand(0.0f);
+            }
+            
+            for (int tapIndex = 0; tapIndex < numTaps; ++tapIndex){
+                float tapLength = limitDelayLength(tapDelayStart[tapIndex] + tapDelayIncrement[tapIndex] * (float) sample + modulation, Interpolator::minimumDelay);
+                const float send = tapSendStart[tapIndex] + tapSendIncrement[tapIndex] * (float) sample;
+                
+                for (int reg = firstRegister; reg < lastRegister; ++reg){
+                    auto tap = [this, reg, position](int delay){
+                        return readRegister<isMasked>(position - (juce::uint32) delay, reg);
+                    };
+                    const int gainIndex = tapIndex * registersPerFrame + reg;
+                    const SIMDSample output = Interpolator::read(tap, tapLength, interleavedTapStates[(size_t) gainIndex]);
+                    
+                    interleavedReadFrame[reg] += output * (tapGainStarts[gainIndex] + tapGainIncrements[gainIndex] * (float) sample);
+                    interleavedFeedbackFrame[reg] += output * send;
+                }
+            }
+        }
+        else if (isMultiTap){
+            for (int channel = firstChannel; channel < lastChannel; ++channel){
+                float modulation = lfo.getChannelBlock(channel)[sample] * depthSamples;
+                const float* gainStart = tapTable.getGainStart(channel);
+                const float* gainIncrement = tapTable.getGainIncrement(channel);
+                
+                gatheredFrame[channel] = 0.0f;
+                gatheredFeedback[channel] = 0.0f;
+                
+                for (int tapIndex = 0; tapIndex < numTaps; ++tapIndex){
+                    float tapLength = limitDelayLength(tapDelayStart[tapIndex] + tapDelayIncrement[tapIndex] * (float) sample + modulation, Interpolator::minimumDelay);
+                    
+                    auto tap = [this, channel, position](int delay){
+                        return readLane<isMasked>(position - (juce::uint32) delay, channel);
+                    };
+                    const SampleType output = Interpolator::read(tap, tapLength, tapLaneStates[tapIndex * frameStride + channel]);
+                    
+                    gatheredFrame[channel] += output * (gainStart[tapIndex] + gainIncrement[tapIndex] * (float) sample);
+                    gatheredFeedback[channel] += output * (tapSendStart[tapIndex] + tapSendIncrement[tapIndex] * (float) sample);
+                }
+            }
+        }
+        else if (lanesShareDelay){
+            float modulation = isModulating ? lfo.getChannelBlock(0)[sample] * depthSamples : 0.0f;
+            float modulatedLength = limitDelayLength(currentDelayLength + modulation, Interpolator::minimumDelay);
+            float outgoingModulated = isJumping ? limitDelayLength(outgoingLength + modulation, Interpolator::minimumDelay) : 0.0f;
+            
+            for (int reg = firstRegister; reg < lastRegister; ++reg){
+                auto tap = [this, reg, position](int delay){
+                    return readRegister<isMasked>(position - (juce::uint32) delay, reg);
+                };
+                interleavedReadFrame[reg] = Interpolator::read(tap, modulatedLength, interleavedInterpolatorState[reg]);
+                
+                if (isJumping){
+                    const SIMDSample outgoing = Interpolator::read(tap, outgoingModulated, interleavedOutgoingState[reg]);
+                    interleavedReadFrame[reg] = outgoing + (interleavedReadFrame[reg] - outgoing) * getJumpGain(sample);
+                }
+            }
+        }
+        else {
+            for (int channel = firstChannel; channel < lastChannel; ++channel){
+                float modulation = lfo.getChannelBlock(channel)[sample] * depthSamples;
+                float modulatedLength = limitDelayLength(currentDelayLength + modulation, Interpolator::minimumDelay);
+                
+                auto tap = [this, channel, position](int delay){
+                    return readLane<isMasked>(position - (juce::uint32) delay, channel);
+                };
+                gatheredFrame[channel] = Interpolator::read(tap, modulatedLength, laneStates[channel]);
+                
+                if (isJumping){
+                    float outgoingModulated = limitDelayLength(outgoingLength + modulation, Interpolator::minimumDelay);
+                    const SampleType outgoing = Interpolator::read(tap, outgoingModulated, outgoingLaneStates[channel]);
+                    gatheredFrame[channel] = outgoing + (gatheredFrame[channel] - outgoing) * getJumpGain(sample);
+                }
+            }
+        }
+        
+        for (int reg = firstRegister; reg < lastRegister; ++reg){
+            const SIMDSample input = inputFrame[reg];
+            const SIMDSample delayOutput = interleavedReadFrame[reg];
+            
+            const SIMDSample written = input + feedbackChain.process(feedbackFrame[reg] * currentFeedback, reg);
+            writeFrame[reg] = written;
+            if (measuringPeaks){
+                writtenPeak = SIMDSample::max(writtenPeak, SIMDSample::abs(written));
+            }
+            inputFrame[reg] = input * currentDryGain + delayOutput * currentWetGain;
+        }
+    }
+    
+    for (int channel = firstChannel; channel < lastChannel; ++channel){
+        SampleType* channelData = block.getChannelPointer(channel);
+        for (int sample = 0; sample < numSamples; ++sample){
+            channelData[sample] = interleavedData[sample * frameStride + channel];
+        }
+        shapeOutput(channelData, numSamples, channel);
+    }
+    
+    SampleType groupPeak = 0;
+    for (size_t lane = 0; lane < SIMDSample::SIMDNumElements; ++lane){
+        groupPeak = juce::jmax(groupPeak, writtenPeak.get(lane));
+    }
+    groupPeaks[(size_t) group] = groupPeak;
+}
+
+template <typename SampleType>
+template <typename Interpolator, bool isContiguous, bool isMasked>
+SampleType Delay<SampleType>::readFromBuffer(int channel, juce::uint32 position, float delaySamples, SampleType& interpolatorState){
+    auto tap = [this, channel, position](int delay){
+        const juce::uint32 frame = position - (juce::uint32) delay;
+        if constexpr (isMasked){
+            if (delayMemory.isStale(channel, frame)){
+                return (SampleType) 0;
+            }
+        }
+        if constexpr (isContiguous){
+            return delayMemory.getContiguousSample(channel, frame);
+        }
+        else {
+            return delayMemory.getSample(channel, frame);
+        }
+    };
+    
+    return Interpolator::read(tap, delaySamples, interpolatorState);
+}
+
+template <typename SampleType>
+template <typename Interpolator, bool isContiguous, bool isMasked>
+SampleType Delay<SampleType>::readTaps(int channel, juce::uint32 position, int sample, float modulation, SampleType& feedbackSum){
+    
+    const int numTaps = tapTable.getNumTaps();
+    const float* delayStart = tapTable.getDelayStart();
+    const float* delayIncrement = tapTable.getDelayIncrement();
+    const float* gainStart = tapTable.getGainStart(channel);
+    const float* gainIncrement = tapTable.getGainIncrement(channel);
+    const float* sendStart = tapTable.getSendStart();
+    const float* sendIncrement = tapTable.getSendIncrement();
+    SampleType* states = tapTable.getInterpolatorStates(channel);
+    
+    // Only the memory reads are per tap; the sweeps either side of them run
+    // over contiguous arrays and vectorise across the taps
+    float tapLengths[MAX_TAPS];
+    SampleType tapOutputs[MAX_TAPS];
+    
+    for (int tap = 0; tap < numTaps; ++tap){
+        tapLengths[tap] = limitDelayLength(delayStart[tap] + delayIncrement[tap] * (float) sample + modulation, Interpolator::minimumDelay);
+    }
+    
+    for (int tap = 0; tap < numTaps; ++tap){
+        tapOutputs[tap] = readFromBuffer<Interpolator, isContiguous, isMasked>(channel, position, tapLengths[tap], states[tap]);
+    }
+    
+    SampleType output = 0;
+    for (int tap = 0; tap < numTaps; ++tap){
+        output += tapOutputs[tap] * (gainStart[tap] + gainIncrement[tap] * (float) sample);
+        feedbackSum += tapOutputs[tap] * (sendStart[tap] + sendIncrement[tap] * (float) sample);
+    }
+    return output;
+}
+
+// Masked lanes are cleared bitwise rather than multiplied by zero, so
+// nothing from a broken channel's memory gets through, NaNs included
+template <typename SampleType>
+template <bool isMasked>
+typename Delay<SampleType>::SIMDSample Delay<SampleType>::readRegister(juce::uint32 frame, int reg) const {
+    const SIMDSample value = reinterpret_cast<const SIMDSample*>(delayMemory.getFrame(frame))[reg];
+    if constexpr (isMasked){
+        using MaskType = typename SIMDSample::MaskType;
+        typename SIMDSample::vMaskType liveLanes;
+        for (size_t lane = 0; lane < SIMDSample::SIMDNumElements; ++lane){
+            const int channel = reg * (int) SIMDSample::SIMDNumElements + (int) lane;
+            liveLanes.set(lane, delayMemory.isStale(channel, frame) ? (MaskType) 0 : ~(MaskType) 0);
+        }
+        return value & liveLanes;
+    }
+    return value;
+}
+
+template <typename SampleType>
+template <bool isMasked>
+SampleType Delay<SampleType>::readLane(juce::uint32 frame, int channel) const {
+    if constexpr (isMasked){
+        if (delayMemory.isStale(channel, frame)){
+            return 0;
+        }
+    }
+    return delayMemory.getFrame(frame)[channel];
+}
+
+// Spreads each tap's per-channel gain ramp across the interleaved lanes
+template <typename SampleType>
+void Delay<SampleType>::updateInterleavedTapGains(){
+    
+    const int numChannels = (int) channelStates.size();
+    SampleType* starts = reinterpret_cast<SampleType*>(interleavedTapGains.data());
+    SampleType* increments = reinterpret_cast<SampleType*>(interleavedTapGains.data() + MAX_TAPS * registersPerFrame);
+    const int frameStride = registersPerFrame * (int) SIMDSample::SIMDNumElements;
+    
+    for (int channel = 0; channel < numChannels; ++channel){
+        const float* gainStart = tapTable.getGainStart(channel);
+        const float* gainIncrement = tapTable.getGainIncrement(channel);
+        
+        for (int tap = 0; tap < tapTable.getNumTaps(); ++tap){
+            starts[tap * frameStride + channel] = gainStart[tap];
+            increments[tap * frameStride + channel] = gainIncrement[tap];
+        }
+    }
+}
+
+template <typename SampleType>
+template <bool isContiguous>
+SampleType Delay<SampleType>::writeToBuffer(int channel, juce::uint32 position, SampleType input, SampleType delayOutput, SampleType feedbackGain){
+    SampleType delayInput = input + feedbackChain.process(delayOutput * feedbackGain, channel);
+    if constexpr (isContiguous){
+        delayMemory.setContiguousSample(channel, position, delayInput);
+    }
+    else {
+        delayMemory.setSample(channel, position, delayInput);
+    }
+    return delayInput;
+}
+
+template <typename SampleType>
+void Delay<SampleType>::setDelayLength(const int delayTime_ms){
+    
+    jassert(isPrepared);
+    jassert(delayTime_ms > 0);
+    
+    centerDelayLength = convertMStoSample((float) delayTime_ms);
+    
+    if (centerDelayLength > maxDelayLength){
+        centerDelayLength = (float) maxDelayLength;
+    }
+    network.setDelayLength(centerDelayLength);
+}
+
+template <typename SampleType>
+void Delay<SampleType>::setDelayTimeMode(const DelayTimeMode mode){
+    timeMode = mode;
+}
+
+// Called once per block, after the parameters for it have been set
+template <typename SampleType>
+void Delay<SampleType>::retargetHead(){
+    
+    if (centerDelayLength == delayLength.getTarget(0) && delayLength.isSet(0)){
+        return;
+    }
+    
+    // One jump at a time; the latest time is picked up once this one is done
+    if (jumpRemaining > 0){
+        return;
+    }
+    
+    // Tape only glides as far as it can within maximumGlideLength at
+    // TAPE_MAX_GLIDE_SPEED, so the pitch bend stays bounded; further, it jumps
+    const float distance = std::abs(centerDelayLength - delayLength.getCurrent(0));
+    const bool isTooFarToGlide = distance > (float) maximumGlideLength * TAPE_MAX_GLIDE_SPEED;
+    
+    if ((timeMode == DelayTimeMode::jump || isTooFarToGlide) && delayLength.isSet(0)){
+        // The outgoing head carries on from wherever the head was, with its
+        // state, while the new head starts from a copy of it faded in from silence
+        outgoingLength = delayLength.getCurrent(0);
+        delayLength.setTarget(0, centerDelayLength, 0);
+        jumpRemaining = jumpFadeLength;
+        
+        for (auto& channelState : channelStates){
+            channelState.outgoingState = channelState.interpolatorState;
+        }
+        std::copy(interleavedInterpolatorState.begin(), interleavedInterpolatorState.end(), interleavedOutgoingState.begin());
+        return;
+    }
+    
+    // The glide takes longer the further it goes, so the pitch bends by at
+    // most TAPE_MAX_GLIDE_SPEED
+    delayLength.setTarget(0, centerDelayLength, juce::jmax(minimumGlideLength, (int) std::ceil(distance / TAPE_MAX_GLIDE_SPEED)));
+}
+
+// Linear, as the two heads read the same signal at different times
+template <typename SampleType>
+SampleType Delay<SampleType>::getJumpGain(int sample) const {
+    return (SampleType) juce::jmin(1.0f, (float) (jumpFadeLength - jumpRemaining + sample + 1) / (float) jumpFadeLength);
+}
+
+template <typename SampleType>
+void Delay<SampleType>::setMix(const float newValue){
+    
+    jassert(isPrepared);
+    
+    this->mix = newValue;
+}
+
+template <typename SampleType>
+void Delay<SampleType>::setFeedback(const float newValue){
+    
+    jassert(isPrepared);
+    
+    this->feedback.setTargetValue(newValue);
+}
+
+template <typename SampleType>
+void Delay<SampleType>::setRate(const float newValue){
+    
+    jassert(isPrepared);
+    
+    this->rate.setTargetValue(newValue);
+    
+}
+
+template <typename SampleType>
+void Delay<SampleType>::setDepth(const int depth){
+    
+    jassert(isPrepared);
+    
+    this->depth = depth;
+}
+
+template <typename SampleType>
+void Delay<SampleType>::setPhaseSpread(const float spread_degrees){
+    
+    jassert(isPrepared);
+    
+    // Each channel's LFO lags the previous one by the spread
+    for (int channel = 0; channel < channelStates.size(); ++channel){
+        lfo.setPhaseOffset(channel, juce::degreesToRadians(spread_degrees * channel));
+    }
+}
+
+template <typename SampleType>
+void Delay<SampleType>::setHighCut(const float frequency){
+    
+    jassert(isPrepared);
+    
+    if (frequency == highCutFrequency){
+        return;
+    }
+    highCutFrequency = frequency;
+    
+    for (auto* chain : { &feedbackChain, &networkChain }){
+        chain->template getStage<0>().setCutoff(lastSampleRate, frequency);
+    }
+}
+
+template <typename SampleType>
+void Delay<SampleType>::setLowCut(const float frequency){
+    
+    jassert(isPrepared);
+    
+    if (frequency == lowCutFrequency){
+        return;
+    }
+    lowCutFrequency = frequency;
+    
+    // Switched off, the stage would keep subtracting whatever low end it
+    // last held, a DC offset recirculating in every repeat
+    const bool isOff = frequency <= FEEDBACK_LOW_CUT_OFF_HZ;
+    for (auto* chain : { &feedbackChain, &networkChain }){
+        chain->template getStage<1>().setCutoff(lastSampleRate, frequency);
+        if (isOff){
+            chain->template resetStage<1>();
+        }
+    }
+}
+
+template <typename SampleType>
+void Delay<SampleType>::setSaturation(const float amount){
+    
+    jassert(isPrepared);
+    
+    for (auto* chain : { &feedbackChain, &networkChain }){
+        chain->template getStage<2>().setAmount(amount);
+    }
+}
+
+template <typename SampleType>
+void Delay<SampleType>::setOutputShape(const OutputShape shape){
+    outputStage.setShape(shape);
+}
+
+template <typename SampleType>
+void Delay<SampleType>::setNumTaps(const int numTaps){
+    
+    jassert(isPrepared);
+    
+    tapTable.setNumTaps(numTaps);
+}
+
+template <typename SampleType>
+void Delay<SampleType>::setTap(const int tap, const float time_ms, const float gain, const float pan, const float feedbackSend){
+    
+    jassert(isPrepared);
+    jassert(time_ms > 0);
+    
+    const float delay_samples = juce::jmin(convertMStoSample(time_ms), (float) maxDelayLength);
+    tapTable.setTap(tap, delay_samples, gain, pan, feedbackSend);
+}
+
+template <typename SampleType>
+void Delay<SampleType>::setBypassed(const bool newValue){
+    if (newValue == bypassed){
+        return;
+    }
+    this->bypassed = newValue;
+}
+
+template <typename SampleType>
+bool Delay<SampleType>::isBypassFading() const {
+    return bypassed ? bypassFadePosition < bypassFadeLength : bypassFadePosition > 0;
+}
+
+template <typename SampleType>
+void Delay<SampleType>::renderBypassGains(int numSamples){
+    
+    SampleType* processedGain = bypassGains.getWritePointer(0);
+    SampleType* dryGain = bypassGains.getWritePointer(1);
+    const int direction = bypassed ? 1 : -1;
+    
+    for (int sample = 0; sample < numSamples; ++sample){
+        bypassFadePosition = juce::jlimit(0, bypassFadeLength, bypassFadePosition + direction);
+        
+        const float angle = juce::MathConstants<float>::halfPi * (float) bypassFadePosition / (float) bypassFadeLength;
+        processedGain[sample] = std::cos(angle);
+        dryGain[sample] = std::sin(angle);
+    }
+}
+
+// Equal-power crossfade between the processed block and the dry input
+template <typename SampleType>
+void Delay<SampleType>::mixBypass(juce::dsp::AudioBlock<SampleType>& block){
+    
+    const int numSamples = (int) block.getNumSamples();
+    renderBypassGains(numSamples);
+    
+    for (size_t channel = 0; channel < block.getNumChannels(); ++channel){
+        SampleType* channelData = block.getChannelPointer(channel);
+        juce::FloatVectorOperations::multiply(channelData, bypassGains.getReadPointer(0), numSamples);
+        juce::FloatVectorOperations::addWithMultiply(channelData, dryBlock.getReadPointer((int) channel), bypassGains.getReadPointer(1), numSamples);
+    }
+}
+
+template <typename SampleType>
+void Delay<SampleType>::setQuality(const DelayQuality newQuality){
+    
+    jassert(isPrepared);
+    
+    if (newQuality == quality){
+        return;
+    }
+    this->quality = newQuality;
+    
+    // The block in flight keeps its interpolator and fades to the new one.
+    // A network doesn't interpolate, so it has nothing to fade.
+    const DelayInterpolation previous = activeInterpolation;
+    applyQuality();
+    if (activeInterpolation != previous && networkSize == 0){
+        fadingInterpolation = previous;
+        fadingNetworkSize = 0;
+        fadeRemaining = fadeLength;
+    }
+}
+
+template <typename SampleType>
+void Delay<SampleType>::setNetworkSize(const int numLines){
+    
+    jassert(isPrepared);
+    jassert(numLines == 0 || FeedbackNetwork<SampleType>::isValidSize(numLines));
+    
+    const int newSize = FeedbackNetwork<SampleType>::isValidSize(numLines) ? numLines : 0;
+    if (newSize == networkSize){
+        return;
+    }
+    
+    // A memory coming back into use mustn't replay what it held when it was
+    // left. One still fading out was written all along and plays on. One
+    // being flushed hasn't been written since it was left, so its flush
+    // starts over from here, and its reads stay masked until that is done.
+    if (newSize == 0){
+        lineFlushing = false;
+        if (delayMemory.isFlushing()){
+            delayMemory.startFlush(writePosition);
+        }
+    }
+    if (networkSize == 0){
+        networkFlushing = false;
+        if (network.isFlushing()){
+            network.startFlush(writePosition);
+        }
+    }
+    
+    // The memory left behind is flushed once the fade no longer reads it
+    if (networkSize == 0){
+        lineFlushing = true;
+    }
+    else if (newSize == 0){
+        networkFlushing = true;
+    }
+    
+    fadingInterpolation = activeInterpolation;
+    fadingNetworkSize = networkSize;
+    fadeRemaining = fadeLength;
+    networkSize = newSize;
+}
+
+template <typename SampleType>
+void Delay<SampleType>::applyQuality(){
+    switch (quality){
+        case DelayQuality::high:
+            activeInterpolation = interpolation;
+            controlInterval = 1;
+            break;
+        case DelayQuality::medium:
+            activeInterpolation = interpolation;
+            controlInterval = MEDIUM_QUALITY_CONTROL_INTERVAL;
+            break;
+        case DelayQuality::low:
+            activeInterpolation = DelayInterpolation::linear;
+            controlInterval = LOW_QUALITY_CONTROL_INTERVAL;
+            break;
+    }
+    lfo.setUpdateInterval(controlInterval);
+}
+
+template <typename SampleType>
+void Delay<SampleType>::setLongDelayMode(const bool enabled){
+    longDelayMode = enabled;
+}
+
+template <typename SampleType>
+void Delay<SampleType>::setParallelGroups(const bool enabled){
+    parallelGroups = enabled;
+}
+
+template <typename SampleType>
+void Delay<SampleType>::setNonRealtime(const bool isNonRealtime){
+    delayMemory.setNonRealtime(isNonRealtime);
+}
+
+//-----------------------------------------------------------------------------
+// Snapshot
+//-----------------------------------------------------------------------------
+// Room for the reach as of the last block, and a second more in case it
+// grows before the copy starts
+template <typename SampleType>
+void Delay<SampleType>::requestSnapshot(){
+    
+    jassert(isPrepared);
+    jassert(snapshotState.load() == snapshotIdle || snapshotState.load() == snapshotReady);
+    
+    const int numChannels = (int) channelStates.size();
+    const int capacity = juce::jmin(getRingReach(), lastReadReach.load(std::memory_order_relaxed) + (int) lastSampleRate);
+    
+    snapshotFrames.resize((size_t) capacity * (size_t) numChannels);
+    snapshotStates.resize((size_t) numChannels * (MAX_TAPS + 1));
+    snapshotCopied.store(0, std::memory_order_relaxed);
+    snapshotState.store(snapshotRequested, std::memory_order_release);
+}
+
+template <typename SampleType>
+bool Delay<SampleType>::isSnapshotReady() const {
+    return snapshotState.load(std::memory_order_acquire) == snapshotReady;
+}
+
+template <typename SampleType>
+void Delay<SampleType>::finishSnapshot(){
+    if (snapshotState.load() == snapshotRequested){
+        startSnapshotCapture();
+    }
+    if (snapshotState.load() == snapshotCapturing){
+        continueSnapshotCapture(snapshotLength);
+    }
+}
+
+// Copying at least a block's worth per block keeps the copy ahead of the
+// write head, which would otherwise overwrite the oldest frames first
+template <typename SampleType>
+void Delay<SampleType>::continueSnapshot(int numSamples){
+    const int state = snapshotState.load(std::memory_order_acquire);
+    if (state == snapshotRequested){
+        startSnapshotCapture();
+    }
+    if (state == snapshotRequested || state == snapshotCapturing){
+        continueSnapshotCapture(juce::jmax(numSamples, snapshotLength / SNAPSHOT_BLOCKS));
+    }
+}
+
+template <typename SampleType>
+void Delay<SampleType>::startSnapshotCapture(){
+    
+    snapshotChannels = (int) channelStates.size();
+    snapshotPosition = writePosition;
+    snapshotSine = lfo.getPhaseSine();
+    snapshotCosine = lfo.getPhaseCosine();
+    
+    // A buffer sized before the channel count changed holds nothing usable
+    if (snapshotStates.size() != (size_t) snapshotChannels * (MAX_TAPS + 1)){
+        snapshotLength = 0;
+        snapshotState.store(snapshotReady, std::memory_order_release);
+        return;
+    }
+    snapshotLength = juce::jmin(getReadReach(), (int) (snapshotFrames.size() / (size_t) snapshotChannels));
+    
+    for (int channel = 0; channel < snapshotChannels; ++channel){
+        for (int tap = -1; tap < MAX_TAPS; ++tap){
+            snapshotStates[(size_t) (channel * (MAX_TAPS + 1) + tap + 1)] = (double) getInterpolatorState(channel, tap);
+        }
+    }
+    
+    snapshotCopied.store(0, std::memory_order_relaxed);
+    snapshotState.store(snapshotCapturing, std::memory_order_relaxed);
+}
+
+// Frames a flush hasn't reached yet are copied as the silence the reads hear
+template <typename SampleType>
+void Delay<SampleType>::continueSnapshotCapture(int maxFrames){
+    
+    const int copied = snapshotCopied.load(std::memory_order_relaxed);
+    const int end = juce::jmin(snapshotLength, copied + maxFrames);
+    const bool isMasked = delayMemory.isFlushing();
+    
+    for (int index = copied; index < end; ++index){
+        const juce::uint32 position = snapshotPosition - (juce::uint32) (snapshotLength - index);
+        SampleType* frame = snapshotFrames.data() + (size_t) index * (size_t) snapshotChannels;
+        
+        for (int channel = 0; channel < snapshotChannels; ++channel){
+            frame[channel] = isMasked && delayMemory.isStale(channel, position) ? (SampleType) 0 : delayMemory.readSample(channel, position);
+        }
+    }
+    
+    snapshotCopied.store(end, std::memory_order_relaxed);
+    if (end == snapshotLength){
+        snapshotState.store(snapshotReady, std::memory_order_release);
+    }
+}
+
+template <typename SampleType>
+void Delay<SampleType>::writeSnapshot(juce::OutputStream& stream){
+    
+    jassert(isSnapshotReady());
+    
+    stream.writeDouble(lastSampleRate);
+    stream.writeInt(snapshotChannels);
+    stream.writeInt(snapshotLength);
+    stream.writeInt((int) sizeof(SampleType));
+    stream.writeInt((int) snapshotPosition);
+    stream.writeFloat(snapshotSine);
+    stream.writeFloat(snapshotCosine);
+    
+    // States are few, so they are stored as double whatever the sample type
+    for (const double state : snapshotStates){
+        stream.writeDouble(state);
+    }
+    
+    // Frames are stored oldest first with the channels side by side, whatever
+    // the layout, so a snapshot restores into either
+    const size_t numSamples = (size_t) snapshotLength * (size_t) snapshotChannels;
+    for (size_t index = 0; index < numSamples; ++index){
+        if constexpr (std::is_same_v<SampleType, float>){
+            stream.writeFloat(snapshotFrames[index]);
+        }
+        else {
+            stream.writeDouble(snapshotFrames[index]);
+        }
+    }
+    
+    std::vector<SampleType>().swap(snapshotFrames);
+    snapshotState.store(snapshotIdle, std::memory_order_relaxed);
+}
+
+template <typename SampleType>
+bool Delay<SampleType>::readSnapshot(juce::InputStream& stream){
+    
+    jassert(isPrepared);
+    
+    const int numChannels = (int) channelStates.size();
+    
+    const double sampleRate = stream.readDouble();
+    const int snapshotChannels = stream.readInt();
+    const int numFrames = stream.readInt();
+    const int sampleSize = stream.readInt();
+    
+    const juce::int64 numStateBytes = (juce::int64) numChannels * (MAX_TAPS + 1) * (juce::int64) sizeof(double);
+    const juce::int64 numFrameBytes = (juce::int64) numFrames * numChannels * sampleSize;
+    
+    if (sampleRate != lastSampleRate || snapshotChannels != numChannels || numFrames <= 0 || numFrames > getRingReach()
+        || (sampleSize != (int) sizeof(float) && sampleSize != (int) sizeof(double))
+        || stream.getNumBytesRemaining() < 12 + numStateBytes + numFrameBytes){
+        return false;
+    }
+    
+    writePosition = (juce::uint32) stream.readInt();
+    const float sine = stream.readFloat();
+    const float cosine = stream.readFloat();
+    lfo.setPhase(sine, cosine);
+    
+    for (int channel = 0; channel < numChannels; ++channel){
+        for (int tap = -1; tap < MAX_TAPS; ++tap){
+            getInterpolatorState(channel, tap) = (SampleType) stream.readDouble();
+        }
+    }
+    
+    // Frames the snapshot didn't reach must read as silence rather than
+    // whatever was there before. Only the pages it covers are committed;
+    // the rest stay silent until the write head reaches them.
+    delayMemory.clear();
+    delayMemory.commitPages(writePosition - (juce::uint32) numFrames, numFrames);
+    
+    // A snapshot from the other precision is converted on the way in
+    auto readFrames = [&](auto readSample){
+        for (int age = numFrames; age > 0; --age){
+            const juce::uint32 position = writePosition - (juce::uint32) age;
+            for (int channel = 0; channel < numChannels; ++channel){
+                delayMemory.writeSample(channel, position, (SampleType) readSample());
+            }
+        }
+    };
+    
+    if (sampleSize == (int) sizeof(float)){
+        readFrames([&stream]{ return stream.readFloat(); });
+    }
+    else {
+        readFrames([&stream]{ return stream.readDouble(); });
+    }
+    
+    // Nothing in flight survives: no fade, no flush, and the line counts as loud
+    network.clear();
+    feedbackChain.reset();
+    networkChain.reset();
+    fadeRemaining = 0;
+    jumpRemaining = 0;
+    fadingNetworkSize = networkSize;
+    lineFlushing = false;
+    networkFlushing = false;
+    sleeping = false;
+    hasSkipped = false;
+    quietFrames = 0;
+    snapToTargets = true;
+    return true;
+}
+
+template <typename SampleType>
+SampleType& Delay<SampleType>::getInterpolatorState(int channel, int tap){
+    if (bufferLayout == DelayBufferLayout::interleaved){
+        if (tap < 0){
+            return reinterpret_cast<SampleType*>(interleavedInterpolatorState.data())[channel];
+        }
+        return reinterpret_cast<SampleType*>(interleavedTapStates.data())[tap * delayMemory.getFrameStride() + channel];
+    }
+    
+    if (tap < 0){
+        return channelStates[channel].interpolatorState;
+    }
+    return tapTable.getInterpolatorStates(channel)[tap];
+}
+
+template <typename SampleType>
+void Delay<SampleType>::snapSmoothers(){
+    delayLength.snap();
+    jumpRemaining = 0;
+    dryGain.setCurrentAndTargetValue(dryGain.getTargetValue());
+    wetGain.setCurrentAndTargetValue(wetGain.getTargetValue());
+    feedback.setCurrentAndTargetValue(feedback.getTargetValue());
+    rate.setCurrentAndTargetValue(rate.getTargetValue());
+    lfo.setFrequency(rate.getTargetValue());
+    
+    bypassFadePosition = bypassed ? bypassFadeLength : 0;
+    snapToTargets = false;
+}
+
+template <typename SampleType>
+void Delay<SampleType>::clearDelayLine(){
+    delayMemory.clear();
+    network.clear();
+    feedbackChain.reset();
+    networkChain.reset();
+    quietFrames = getRingReach();
+}
+
+//-----------------------------------------------------------------------------
+// Utility
+//-----------------------------------------------------------------------------
+template <typename SampleType>
+float Delay<SampleType>::convertMStoSample(const float time){
+    return (float) (0.001 * time * lastSampleRate);
+}
+
+template <typename SampleType>
+float Delay<SampleType>::lerp(float a, float b, float f)
+{
+    return a * (1.0 - f) + (b * f);
+}
+
+template <typename SampleType>
+float Delay<SampleType>::limitDelayLength(float delayLength, float minimumDelay){
+    
+    // Anything shorter would read the slot that is about to be written
+    float result = delayLength;
+    if (delayLength < minimumDelay){
+        result = minimumDelay;
+    }
+    if (delayLength >= maxDelayLength){
+        result = (float) maxDelayLength;
+    }
+    return result;
+}
+
+template <typename SampleType>
+SampleType Delay<SampleType>::getPeak(const SampleType* data, int numSamples){
+    const auto range = juce::FloatVectorOperations::findMinAndMax(data, numSamples);
+    return juce::jmax(-range.getStart(), range.getEnd());
+}
+
+template <typename SampleType>
+SampleType Delay<SampleType>::getPeak(const juce::dsp::AudioBlock<SampleType>& block){
+    SampleType peak = 0;
+    for (size_t channel = 0; channel < block.getNumChannels(); ++channel){
+        peak = juce::jmax(peak, getPeak(block.getChannelPointer(channel), (int) block.getNumSamples()));
+    }
+    return peak;
+}
+
+// Runs inside the groups, so a channel that blew up is only flagged here
+// and reset once the groups are done
+template <typename SampleType>
+void Delay<SampleType>::shapeOutput(SampleType* data, int numSamples, int channel){
+    if (!outputStage.process(data, numSamples, channel)){
+        channelStates[(size_t) channel].needsReset = true;
+    }
+}
+
+// A NaN or infinity in the memory would echo forever, so a channel whose
+// output wasn't finite loses its history, this block's frames included.
+// Its memory is flushed like any other, its reads muted until then. The
+// network's lines feed every channel, so it is flushed whole.
+template <typename SampleType>
+void Delay<SampleType>::resetBrokenChannels(int numSamples){
+    
+    const juce::uint32 watermark = writePosition + (juce::uint32) numSamples;
+    
+    for (auto& channelState : channelStates){
+        if (!channelState.needsReset){
+            continue;
+        }
+        channelState.needsReset = false;
+        
+        const int channel = channelState.channel;
+        delayMemory.startChannelFlush(channel, watermark);
+        getInterpolatorState(channel, -1) = 0;
+        channelState.outgoingState = 0;
+        if (!interleavedOutgoingState.empty()){
+            reinterpret_cast<SampleType*>(interleavedOutgoingState.data())[channel] = 0;
+        }
+        for (int tap = 0; tap < MAX_TAPS; ++tap){
+            getInterpolatorState(channel, tap) = 0;
+        }
+        feedbackChain.resetChannel(channel);
+        outputStage.resetChannel(channel);
+        
+        if (networkSize > 0 || fadingNetworkSize > 0){
+            network.startFlush(watermark);
+            networkChain.reset();
+        }
+    }
+}
+
+template class Delay<float>;
+template class Delay<double>;
@@ -1,70 +1,399 @@
-/*
-  ==============================================================================
-
-    Delay.h
-    Created: 21 Aug 2025 3:35:32pm
-    Author:  Chris
-
-  ==============================================================================
-*/
-
-#pragma once
-
-#include <JuceHeader.h>
-#define DEFAULT_MIX 0.5
-#define DEFAULT_FEEDBACK 0.5
-#define DEFAULT_RATE 0.01f
-#define DEFAULT_DEPTH 0.0
-
-typedef struct {
-    int channel;
-    int delayIndex;
-    juce::dsp::Oscillator<float> lfo;
-} ChannelState;
-
-class Delay {
-public:
-    void prepareToPlay(double sampleRate, int samplesPerBlock, int numChannels);
-    void reset();
-    float processSample(int channel, float sample);
-    
-    void setDelayLength(const int delayTime_ms);
-    void setMix(const float mix);
-    void setFeedback(const float feedback);
-    void setRate(const float rate);
-    void setDepth(const int depth);
-    
-    void clearDelayLine();
-private:
-    bool isPrepared { false };
-    double lastSampleRate;
-    
-    std::vector<ChannelState> channelStates;
-    
-    juce::AudioBuffer<float> delayBuffer;
-    int centerDelayLength;
-    juce::SmoothedValue<float> delayLength;
-    int maxDelayLength;
-    
-    float interpolateSample(ChannelState* channelState);
-    
-    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> dryGain, wetGain;
-    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> feedback { DEFAULT_FEEDBACK };
-    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> rate { 0.01f };
-    
-    float mix = DEFAULT_MIX;
-    int depth = DEFAULT_DEPTH; // in ms
-    
-    float readFromBuffer(ChannelState* channelState);
-    void writeToBuffer(ChannelState* channelState, float input);
-    
-    //-----------------------------------------------------------------------------
-    // Utility
-    //-----------------------------------------------------------------------------
-    int convertMStoSample(const int time);
-    float lerp(float a, float b, float f);
-    int limitDelayLength(int delayLength);
-    float limitOutput(float value);
-};
-
-
+/*
+  ==============================================================================
+
+    Delay.h
+    Created: 21 Aug 2025 3:35:32pm
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Interpolation.h"
+#include "LFO.h"
+#include "ParameterRamp.h"
+#include "GlideArray.h"
+#include "DelayMemory.h"
+#include "TapTable.h"
+#include "FeedbackNetwork.h"
+#include "FeedbackChain.h"
+#include "OutputStage.h"
+#include "WorkStealingPool.h"
+#define DEFAULT_MIX 0.5
+#define DEFAULT_FEEDBACK 0.5
+#define DEFAULT_RATE 0.01f
+#define DEFAULT_DEPTH 0.0
+#define MAX_DELAY_SECONDS 1.0
+#define MAX_LONG_DELAY_SECONDS 60.0
+#define MIN_PARALLEL_CHANNELS 8
+#define CHANNELS_PER_GROUP 8
+#define MIN_PARALLEL_SAMPLES 16384  // samples across all channels a block needs before the pool is worth waking
+#define MEDIUM_QUALITY_CONTROL_INTERVAL 8
+#define LOW_QUALITY_CONTROL_INTERVAL 32
+#define QUALITY_FADE_SECONDS 0.01
+#define SILENCE_THRESHOLD 3.1623e-5f  // -90 dB
+#define BYPASS_FADE_SECONDS 0.02
+#define FLUSH_SAMPLES_PER_BLOCK 16384
+#define FLUSH_BLOCKS 32  // blocks a flush of the whole ring takes at most, whatever its size
+#define SNAPSHOT_BLOCKS 16  // and a snapshot copy of the whole reach
+#define TAPE_MIN_GLIDE_SECONDS 0.02
+#define TAPE_MAX_GLIDE_SPEED 0.25f  // samples of delay per sample, so at most a 25% bend in pitch
+#define TAPE_MAX_GLIDE_SECONDS 0.3  // a change too far to glide within this at that speed jumps instead
+#define JUMP_FADE_SECONDS 0.005
+
+// High and medium read with the interpolator given to prepareToPlay, low
+// falls back to linear. Below high, the LFO and the feedback smoothing are
+// updated once per control interval instead of every sample.
+enum class DelayQuality {
+    low,
+    medium,
+    high
+};
+
+// How the read head follows a change of delay time
+enum class DelayTimeMode {
+    tape,  // glides to the new time, bending the pitch by a bounded amount
+    jump   // a second head starts at the new time and the two are crossfaded
+};
+
+// One cache line each, so channels processed on different cores don't contend
+template <typename SampleType>
+struct alignas(64) ChannelState {
+    int channel;
+    SampleType interpolatorState;
+    SampleType outgoingState;  // the outgoing head's, while a jump fades
+    bool needsReset = false;  // its output wasn't finite, so its history is to be cleared
+};
+
+//==============================================================================
+/*
+    The delay line, for float or double signals.
+
+    SampleType is the type of the audio, the delay memory, the interpolators'
+    state and the feedback and mix gains, so a double instance recirculates
+    its feedback in double. Delay times, the LFO and the taps' settings are
+    control values and stay float either way.
+*/
+template <typename SampleType>
+class Delay {
+public:
+    void prepareToPlay(double sampleRate, int samplesPerBlock, int numChannels,
+                       DelayBufferLayout layout = DelayBufferLayout::planar,
+                       DelayInterpolation interpolationType = DelayInterpolation::linear);
+    void reset();
+    
+    // Long-delay mode raises the maximum delay to MAX_LONG_DELAY_SECONDS and
+    // commits the delay memory lazily. Takes effect at the next prepareToPlay.
+    void setLongDelayMode(const bool enabled);
+    
+    // Shares channel groups out over a worker pool when there are at least
+    // MIN_PARALLEL_CHANNELS channels. Off by default, so a delay only spawns
+    // workers when asked to; blocks under MIN_PARALLEL_SAMPLES run inline
+    // either way. Takes effect at the next prepareToPlay.
+    void setParallelGroups(const bool enabled);
+    
+    // Offline renders can outrun the lazy memory's page allocator, so the
+    // delay then allocates any page it writes to on the spot
+    void setNonRealtime(const bool isNonRealtime);
+    
+    void process(const juce::dsp::ProcessContextReplacing<SampleType>& context);
+    
+    void setDelayLength(const int delayTime_ms);
+    
+    // Tape glides the single head to a new time over at least
+    // TAPE_MIN_GLIDE_SECONDS and never faster than TAPE_MAX_GLIDE_SPEED. A
+    // change that would take longer than TAPE_MAX_GLIDE_SECONDS jumps. Jump
+    // starts a second head at the new time and crossfades to it over
+    // JUMP_FADE_SECONDS; a change arriving mid-fade waits for it to finish.
+    // Taps and network lines glide as before in either mode.
+    void setDelayTimeMode(const DelayTimeMode mode);
+    
+    void setMix(const float mix);
+    void setFeedback(const float feedback);
+    void setRate(const float rate);
+    void setDepth(const int depth);
+    void setPhaseSpread(const float spread_degrees);
+    
+    // The feedback path darkens with the high cut, thins with the low cut and
+    // saturates every repeat on its way back into the memory, the network's
+    // included. At their defaults the stages leave the repeats untouched.
+    void setHighCut(const float frequency);
+    void setLowCut(const float frequency);
+    void setSaturation(const float amount);
+    
+    // How the output is kept within full scale: a hard clip, or one of two
+    // anti-aliased tanh curves that round off a hot feedback loop
+    void setOutputShape(const OutputShape shape);
+    
+    // Multi-tap mode: with one or more taps, the taps replace the single read
+    // head. Each tap has its own time, gain, pan and send into the feedback path.
+    void setNumTaps(const int numTaps);
+    void setTap(const int tap, const float time_ms, const float gain, const float pan, const float feedbackSend);
+    
+    // Starts at high. A change of interpolator is crossfaded over
+    // QUALITY_FADE_SECONDS.
+    void setQuality(const DelayQuality quality);
+    DelayQuality getQuality() const { return quality; }
+    
+    // Network mode: with 4, 8 or 16 lines, a feedback delay network replaces
+    // the single line, the taps and the modulation, and the delay time sets
+    // its longest line. 0 goes back to the single line. A change is
+    // crossfaded over QUALITY_FADE_SECONDS, after which the memory left
+    // behind is flushed.
+    void setNetworkSize(const int numLines);
+    int getNetworkSize() const { return networkSize; }
+    
+    // Bypassing crossfades to the dry input with an equal-power law. Once
+    // the fade is done, process() returns at once and flushes the delay
+    // memory, so coming back starts from a clear line. A flush clears a
+    // slice of the memory per block, at least FLUSH_SAMPLES_PER_BLOCK and
+    // enough to be done within FLUSH_BLOCKS, and until then the reads take
+    // what it hasn't reached as silence. Before prepareToPlay, the state
+    // applies without a fade.
+    void setBypassed(const bool bypassed);
+    bool isBypassed() const { return bypassed; }
+    
+    // Asleep, process() leaves blocks untouched. The delay falls asleep once
+    // the input is silent and the whole delay memory has been quiet for a
+    // full ring, and wakes on the first block with input above SILENCE_THRESHOLD.
+    bool isSleeping() const { return sleeping; }
+    
+    // Snapshot of the tail: the frames the read heads can reach, the write
+    // position, the LFO phase and the interpolators' states. A network's
+    // lines aren't included; restoring one clears them, and the feedback
+    // path's filters restart from rest. A restored delay jumps straight to
+    // its parameters' targets on the next block, so the tail plays on
+    // exactly as it would have.
+    //
+    // requestSnapshot() sizes a buffer for the current reach, and process()
+    // then copies the frames into it, oldest first, a slice per block,
+    // keeping the memory's reach until it is done. finishSnapshot() instead
+    // completes the copy in one pass on the calling thread, which must then
+    // be the only one using the delay. Once isSnapshotReady(),
+    // writeSnapshot() serialises it, little-endian.
+    //
+    // readSnapshot() is only for while process() can't run. It takes
+    // snapshots from either precision; it returns false and changes nothing
+    // if the snapshot came from another sample rate, channel count or
+    // longer line.
+    void requestSnapshot();
+    bool isSnapshotReady() const;
+    void finishSnapshot();
+    void writeSnapshot(juce::OutputStream& stream);
+    bool readSnapshot(juce::InputStream& stream);
+    
+    void clearDelayLine();
+private:
+    bool isPrepared { false };
+    double lastSampleRate;
+    
+    std::vector<ChannelState<SampleType>> channelStates;
+    
+    DelayBufferLayout bufferLayout = DelayBufferLayout::planar;
+    DelayInterpolation interpolation = DelayInterpolation::linear;
+    bool longDelayMode = false;
+    bool parallelGroups = false;
+    
+    //-----------------------------------------------------------------------------
+    // Quality
+    //-----------------------------------------------------------------------------
+    DelayQuality quality = DelayQuality::high;
+    DelayInterpolation activeInterpolation = DelayInterpolation::linear;
+    DelayInterpolation fadingInterpolation = DelayInterpolation::linear;
+    int controlInterval = 1;
+    
+    juce::AudioBuffer<SampleType> fadeBlock;  // the outgoing interpolator's output while fading
+    int fadeLength = 0;
+    int fadeRemaining = 0;
+    
+    void applyQuality();
+    void crossfade(juce::dsp::AudioBlock<SampleType>& block);
+    
+    //-----------------------------------------------------------------------------
+    // Delay time
+    //-----------------------------------------------------------------------------
+    DelayTimeMode timeMode = DelayTimeMode::tape;
+    float centerDelayLength;
+    GlideArray delayLength;  // one entry, the single head's delay
+    int minimumGlideLength = 1;
+    int maximumGlideLength = 1;
+    
+    // While a jump fades, the outgoing head stays at the old time and the
+    // head gliding in delayLength has already landed on the new one
+    float outgoingLength = 0.0f;
+    int jumpFadeLength = 1;
+    int jumpRemaining = 0;
+    
+    void retargetHead();
+    SampleType getJumpGain(int sample) const;
+    
+    //-----------------------------------------------------------------------------
+    // Network
+    //-----------------------------------------------------------------------------
+    FeedbackNetwork<SampleType> network;
+    int networkSize = 0;
+    int fadingNetworkSize = 0;  // the outgoing size while fading, 0 for the single line
+    bool lineFlushing = false;  // the single line's memory is to be flushed once the fade stops reading it
+    bool networkFlushing = false;  // and the network's
+    
+    // The single line through its kernels, or a network of numLines lines
+    void runEngine(juce::dsp::AudioBlock<SampleType>& block, DelayInterpolation type, int numLines, bool isModulating);
+    void processNetwork(juce::dsp::AudioBlock<SampleType>& block, int numLines);
+    void continueEngineFlushes(bool isFading);
+    void continueFlushes();
+    
+    //-----------------------------------------------------------------------------
+    // Bypass
+    //-----------------------------------------------------------------------------
+    bool bypassed = false;
+    int bypassFadeLength = 0;
+    int bypassFadePosition = 0;  // 0 is fully active, bypassFadeLength fully bypassed
+    
+    juce::AudioBuffer<SampleType> dryBlock;  // the input while fading
+    juce::AudioBuffer<SampleType> bypassGains;  // channel 0 = processed gain, channel 1 = dry gain
+    
+    bool isBypassFading() const;
+    void renderBypassGains(int numSamples);
+    void mixBypass(juce::dsp::AudioBlock<SampleType>& block);
+    
+    //-----------------------------------------------------------------------------
+    // Silence
+    //-----------------------------------------------------------------------------
+    bool sleeping = false;
+    int quietFrames = 0;  // how many of the latest frames written were all below the threshold
+    bool hasSkipped = false;  // whether the current sleep has skipped a block
+    bool measuringPeaks = false;
+    std::vector<SampleType> groupPeaks;  // loudest sample each group wrote to the memory this block
+    
+    int getRingReach();
+    int getReadReach();
+    int getQuietReach();
+    void updateQuietFrames(int numSamples);
+    void skipBlock(int numSamples);
+    
+    //-----------------------------------------------------------------------------
+    // Snapshot
+    //-----------------------------------------------------------------------------
+    bool snapToTargets = false;  // set by readSnapshot(), cleared by the next block
+    
+    // A capture's header is taken when the copy starts, on the audio thread
+    enum SnapshotState { snapshotIdle, snapshotRequested, snapshotCapturing, snapshotReady };
+    std::atomic<int> snapshotState { snapshotIdle };
+    std::atomic<int> snapshotCopied { 0 };
+    std::atomic<int> lastReadReach { 0 };
+    std::vector<SampleType> snapshotFrames;  // oldest first, channels side by side
+    std::vector<double> snapshotStates;
+    juce::uint32 snapshotPosition = 0;
+    int snapshotChannels = 0;
+    int snapshotLength = 0;
+    float snapshotSine = 0.0f;
+    float snapshotCosine = 0.0f;
+    
+    void continueSnapshot(int numSamples);
+    void startSnapshotCapture();
+    void continueSnapshotCapture(int maxFrames);
+    
+    // The single head's state with tap < 0, otherwise that tap's, in either layout
+    SampleType& getInterpolatorState(int channel, int tap);
+    void snapSmoothers();
+    
+    // The delay memory is a power-of-two ring: the write head only ever moves
+    // forward and every read is at (writePosition - delay), masked by the memory.
+    DelayMemory<SampleType> delayMemory;
+    juce::uint32 writePosition = 0;
+    
+    //-----------------------------------------------------------------------------
+    // Interleaved layout
+    //-----------------------------------------------------------------------------
+    using SIMDSample = juce::dsp::SIMDRegister<SampleType>;
+    
+    std::vector<SIMDSample> interleavedBlock;   // scratch for the interleaved I/O block
+    std::vector<SIMDSample> interleavedInterpolatorState;
+    std::vector<SIMDSample> interleavedOutgoingState;  // the outgoing head's, while a jump fades
+    std::vector<SIMDSample> interleavedReadFrame;  // gathered reads when channels' delays differ
+    std::vector<SIMDSample> interleavedFeedbackFrame;  // multi-tap feedback sum, which differs from the wet sum
+    std::vector<SIMDSample> interleavedTapGains;  // [tap][register] starts, then increments
+    std::vector<SIMDSample> interleavedTapStates;  // [tap][register]
+    int registersPerFrame = 0;
+    int maxBlockSize = 0;
+    
+    int maxDelayLength;
+    
+    juce::SmoothedValue<SampleType, juce::ValueSmoothingTypes::Linear> dryGain, wetGain;
+    juce::SmoothedValue<SampleType, juce::ValueSmoothingTypes::Linear> feedback { DEFAULT_FEEDBACK };
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> rate { 0.01f };
+    
+    LFO lfo;
+    TapTable<SampleType> tapTable;
+    DelayFeedbackChain<SampleType> feedbackChain;  // a lane per channel
+    DelayFeedbackChain<SampleType> networkChain;  // a lane per network line
+    OutputStage<SampleType> outputStage;
+    
+    // The cutoffs the chains' poles were last worked out for, as each costs
+    // an exp(); prepareToPlay() clears them so a new rate gets new poles
+    float highCutFrequency = -1.0f, lowCutFrequency = -1.0f;
+    
+    // Per-block renders of the smoothers above
+    ParameterRamp<SampleType> feedbackRamp, dryRamp, wetRamp;
+    juce::AudioBuffer<SampleType> delayedBlock;  // each channel's delay-line output for the block
+    
+    //-----------------------------------------------------------------------------
+    // Channel groups
+    //-----------------------------------------------------------------------------
+    // Channels are processed in groups: runs of channels in the planar layout,
+    // runs of registers in the interleaved one. With parallel groups on and
+    // MIN_PARALLEL_CHANNELS or more, big blocks share them out over a worker pool.
+    using GroupKernel = void (Delay::*)(juce::dsp::AudioBlock<SampleType>&, bool, int);
+    
+    int groupSize = CHANNELS_PER_GROUP;
+    int numGroups = 1;
+    std::unique_ptr<WorkStealingPool> pool;
+    std::function<void(int)> groupTask;
+    GroupKernel groupKernel = nullptr;
+    juce::dsp::AudioBlock<SampleType>* currentBlock = nullptr;
+    bool currentIsModulating = false;
+    
+    void prepareGroups(int numChannels);
+    void runGroups(juce::dsp::AudioBlock<SampleType>& block, GroupKernel kernel, bool isModulating);
+    
+    float mix = DEFAULT_MIX;
+    int depth = DEFAULT_DEPTH; // in ms
+    
+    // Kernels are specialised per interpolation policy; process() picks one per block
+    GroupKernel selectKernel(DelayInterpolation type);
+    template <typename Interpolator>
+    GroupKernel kernelFor();
+    template <typename Interpolator, bool isContiguous, bool isMasked>
+    void processPlanar(juce::dsp::AudioBlock<SampleType>& block, bool isModulating, int group);
+    template <typename Interpolator, bool isMasked>
+    void processInterleaved(juce::dsp::AudioBlock<SampleType>& block, bool isModulating, int group);
+    
+    // isContiguous skips the page lookup when the whole ring is one page, and
+    // isMasked reads the frames a flush hasn't reached yet as silence
+    template <typename Interpolator, bool isContiguous, bool isMasked>
+    SampleType readFromBuffer(int channel, juce::uint32 position, float delaySamples, SampleType& interpolatorState);
+    template <typename Interpolator, bool isContiguous, bool isMasked>
+    SampleType readTaps(int channel, juce::uint32 position, int sample, float modulation, SampleType& feedbackSum);
+    template <bool isMasked>
+    SIMDSample readRegister(juce::uint32 frame, int reg) const;
+    template <bool isMasked>
+    SampleType readLane(juce::uint32 frame, int channel) const;
+    void updateInterleavedTapGains();
+    template <bool isContiguous>
+    SampleType writeToBuffer(int channel, juce::uint32 position, SampleType input, SampleType delayOutput, SampleType feedbackGain);
+    
+    //-----------------------------------------------------------------------------
+    // Utility
+    //-----------------------------------------------------------------------------
+    float convertMStoSample(const float time);
+    float lerp(float a, float b, float f);
+    float limitDelayLength(float delayLength, float minimumDelay);
+    SampleType getPeak(const SampleType* data, int numSamples);
+    SampleType getPeak(const juce::dsp::AudioBlock<SampleType>& block);
+    void shapeOutput(SampleType* data, int numSamples, int channel);
+    void resetBrokenChannels(int numSamples);
+};
+
+
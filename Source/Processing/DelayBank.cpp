@@ -0,0 +1,296 @@
+/*
+  ==============================================================================
+
+    DelayBank.cpp
+    Created: 17 Oct 2026 5:48:53pm
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#include "DelayBank.h"
+
+template <typename SampleType>
+void DelayBank<SampleType>::prepareToPlay(double sampleRate, int samplesPerBlock, int numLines, DelayInterpolation interpolationType, int numWorkers){
+    lastSampleRate = sampleRate;
+    this->numLines = numLines;
+    interpolation = interpolationType;
+    rampLength = juce::jmax(1, (int) (sampleRate * 0.02));
+    
+    // Eager, so the rings are a single contiguous page, lines back to back
+    maxDelayLength = (int) (sampleRate * MAX_DELAY_SECONDS);
+    delayMemory.prepare(juce::nextPowerOfTwo(maxDelayLength + 3), numLines, DelayBufferLayout::planar, false);
+    
+    for (auto* glide : { &delayLength, &feedback, &dryGain, &wetGain }){
+        glide->resize((size_t) numLines);
+    }
+    
+    lineStates.resize((size_t) numLines);
+    for (int line = 0; line < numLines; ++line){
+        lineStates[(size_t) line].channel = line;
+    }
+    feedbackChain.prepare(numLines);
+    outputStage.prepare(numLines, samplesPerBlock);
+    lowCutFrequency = -1.0f;
+    
+    // Workers are spawned here, never on the audio thread, and only when
+    // there is more than one group to share out
+    numGroups = juce::jmax(1, (numLines + CHANNELS_PER_GROUP - 1) / CHANNELS_PER_GROUP);
+    if (numWorkers < 0){
+        numWorkers = juce::SystemStats::getNumCpus() - 1;
+    }
+    numWorkers = juce::jmin(numWorkers, numGroups - 1);
+    
+    if (numWorkers <= 0){
+        pool.reset();
+    }
+    else if (pool == nullptr || pool->getNumWorkers() != numWorkers){
+        pool = std::make_unique<WorkStealingPool>(numWorkers);
+    }
+    groupTask = [this](int group){ (this->*groupKernel)(group); };
+    
+    isPrepared = true;
+    
+    reset();
+}
+
+template <typename SampleType>
+void DelayBank<SampleType>::reset(){
+    
+    for (int line = 0; line < numLines; ++line){
+        delayLength.setTarget(line, (float) lastSampleRate / 2, 0);
+        feedback.setTarget(line, DEFAULT_FEEDBACK, 0);
+        dryGain.setTarget(line, 2.0f * juce::jmin(0.5f, 1.0f - (float) DEFAULT_MIX), 0);
+        wetGain.setTarget(line, 2.0f * juce::jmin(0.5f, (float) DEFAULT_MIX), 0);
+    }
+    
+    // The first settings after a reset apply at once instead of gliding from the defaults
+    for (auto* glide : { &delayLength, &feedback, &dryGain, &wetGain }){
+        glide->unset();
+    }
+    
+    for (auto& lineState : lineStates){
+        lineState.interpolatorState = 0;
+        lineState.needsReset = false;
+    }
+    feedbackChain.reset();
+    outputStage.reset();
+    
+    clearDelayLines();
+    writePosition = 0;
+}
+
+template <typename SampleType>
+void DelayBank<SampleType>::process(const juce::dsp::ProcessContextReplacing<SampleType>& context){
+    
+    jassert (isPrepared);
+    
+    if (context.isBypassed){
+        return;
+    }
+    
+    auto& block = context.getOutputBlock();
+    const int numSamples = (int) block.getNumSamples();
+    const int numChannels = juce::jmin((int) block.getNumChannels(), numLines);
+    
+    delayMemory.continueFlush(writePosition, juce::jmax(FLUSH_SAMPLES_PER_BLOCK, delayMemory.getNumSamples() / FLUSH_BLOCKS));
+    
+    delayMemory.prepareToWrite(writePosition, numSamples);
+    for (auto* glide : { &delayLength, &feedback, &dryGain, &wetGain }){
+        glide->advance(numChannels, numSamples);
+    }
+    
+    // Groups share nothing but the block, so they can go to the pool
+    groupKernel = selectKernel();
+    currentBlock = &block;
+    
+    const int numBlockGroups = (numChannels + CHANNELS_PER_GROUP - 1) / CHANNELS_PER_GROUP;
+    if (pool != nullptr && (size_t) numSamples * (size_t) numChannels >= MIN_PARALLEL_SAMPLES){
+        pool->run(numBlockGroups, groupTask);
+    }
+    else {
+        for (int group = 0; group < numBlockGroups; ++group){
+            (this->*groupKernel)(group);
+        }
+    }
+    
+    currentBlock = nullptr;
+    resetBrokenLines(numSamples);
+    writePosition += (juce::uint32) numSamples;
+}
+
+template <typename SampleType>
+typename DelayBank<SampleType>::GroupKernel DelayBank<SampleType>::selectKernel(){
+    const bool isMasked = delayMemory.isFlushing();
+    switch (interpolation){
+        case DelayInterpolation::cubicHermite:
+            return isMasked ? &DelayBank::template processGroup<Interpolation::CubicHermite, true>
+                            : &DelayBank::template processGroup<Interpolation::CubicHermite, false>;
+        case DelayInterpolation::lagrange3:
+            return isMasked ? &DelayBank::template processGroup<Interpolation::Lagrange3, true>
+                            : &DelayBank::template processGroup<Interpolation::Lagrange3, false>;
+        case DelayInterpolation::thiran:
+            return isMasked ? &DelayBank::template processGroup<Interpolation::Thiran, true>
+                            : &DelayBank::template processGroup<Interpolation::Thiran, false>;
+        case DelayInterpolation::linear:
+        default:
+            return isMasked ? &DelayBank::template processGroup<Interpolation::Linear, true>
+                            : &DelayBank::template processGroup<Interpolation::Linear, false>;
+    }
+}
+
+template <typename SampleType>
+template <typename Interpolator, bool isMasked>
+void DelayBank<SampleType>::processGroup(int group){
+    
+    const int numChannels = juce::jmin((int) currentBlock->getNumChannels(), numLines);
+    const int numSamples = (int) currentBlock->getNumSamples();
+    const int lastLine = juce::jmin(numChannels, (group + 1) * CHANNELS_PER_GROUP);
+    
+    for (int line = group * CHANNELS_PER_GROUP; line < lastLine; ++line){
+        
+        SampleType* data = currentBlock->getChannelPointer((size_t) line);
+        SampleType& interpolatorState = lineStates[(size_t) line].interpolatorState;
+        
+        const float delayStart = delayLength.getStart()[line];
+        const float delayIncrement = delayLength.getIncrement()[line];
+        const float feedbackStart = feedback.getStart()[line];
+        const float feedbackIncrement = feedback.getIncrement()[line];
+        const float dryStart = dryGain.getStart()[line];
+        const float dryIncrement = dryGain.getIncrement()[line];
+        const float wetStart = wetGain.getStart()[line];
+        const float wetIncrement = wetGain.getIncrement()[line];
+        
+        for (int sample = 0; sample < numSamples; ++sample){
+            const juce::uint32 position = writePosition + (juce::uint32) sample;
+            const float offset = (float) sample;
+            
+            const float delaySamples = juce::jlimit(Interpolator::minimumDelay, (float) maxDelayLength,
+                                                    delayStart + delayIncrement * offset);
+            auto tap = [this, line, position](int delay){
+                const juce::uint32 frame = position - (juce::uint32) delay;
+                if constexpr (isMasked){
+                    if (delayMemory.isStale(line, frame)){
+                        return (SampleType) 0;
+                    }
+                }
+                return delayMemory.getContiguousSample(line, frame);
+            };
+            const SampleType delayed = Interpolator::read(tap, delaySamples, interpolatorState);
+            const SampleType input = data[sample];
+            
+            const SampleType feedbackGain = (SampleType) (feedbackStart + feedbackIncrement * offset);
+            delayMemory.setContiguousSample(line, position, input + feedbackChain.process(delayed * feedbackGain, line));
+            
+            data[sample] = input * (SampleType) (dryStart + dryIncrement * offset) + delayed * (SampleType) (wetStart + wetIncrement * offset);
+        }
+        
+        if (!outputStage.process(data, numSamples, line)){
+            lineStates[(size_t) line].needsReset = true;
+        }
+    }
+}
+
+// As in the Delay, a line whose output wasn't finite loses its history,
+// this block's frames included, and reads silence until its flush is done
+template <typename SampleType>
+void DelayBank<SampleType>::resetBrokenLines(int numSamples){
+    for (auto& lineState : lineStates){
+        if (!lineState.needsReset){
+            continue;
+        }
+        lineState.needsReset = false;
+        lineState.interpolatorState = 0;
+        
+        delayMemory.startChannelFlush(lineState.channel, writePosition + (juce::uint32) numSamples);
+        feedbackChain.resetChannel(lineState.channel);
+        outputStage.resetChannel(lineState.channel);
+    }
+}
+
+template <typename SampleType>
+void DelayBank<SampleType>::setDelayLength(const int line, const int delayTime_ms){
+    
+    jassert(isPrepared);
+    jassert(delayTime_ms > 0);
+    
+    const float delaySamples = juce::jmin(convertMStoSample((float) delayTime_ms), (float) maxDelayLength);
+    if (delaySamples != delayLength.getTarget(line)){
+        delayLength.setTarget(line, delaySamples, rampLength);
+    }
+}
+
+template <typename SampleType>
+void DelayBank<SampleType>::setMix(const int line, const float mix){
+    
+    jassert(isPrepared);
+    
+    // Balanced Dry/Wet Mixing Rule
+    const float dry = 2.0f * juce::jmin(0.5f, 1.0f - mix);
+    const float wet = 2.0f * juce::jmin(0.5f, mix);
+    
+    if (dry != dryGain.getTarget(line) || wet != wetGain.getTarget(line)){
+        dryGain.setTarget(line, dry, rampLength);
+        wetGain.setTarget(line, wet, rampLength);
+    }
+}
+
+template <typename SampleType>
+void DelayBank<SampleType>::setFeedback(const int line, const float newValue){
+    
+    jassert(isPrepared);
+    
+    if (newValue != feedback.getTarget(line)){
+        feedback.setTarget(line, newValue, rampLength);
+    }
+}
+
+template <typename SampleType>
+void DelayBank<SampleType>::setHighCut(const float frequency){
+    jassert(isPrepared);
+    feedbackChain.template getStage<0>().setCutoff(lastSampleRate, frequency);
+}
+
+template <typename SampleType>
+void DelayBank<SampleType>::setLowCut(const float frequency){
+    
+    jassert(isPrepared);
+    
+    if (frequency == lowCutFrequency){
+        return;
+    }
+    lowCutFrequency = frequency;
+    
+    // Switched off, the stage would otherwise hold on to its last low end
+    feedbackChain.template getStage<1>().setCutoff(lastSampleRate, frequency);
+    if (frequency <= FEEDBACK_LOW_CUT_OFF_HZ){
+        feedbackChain.template resetStage<1>();
+    }
+}
+
+template <typename SampleType>
+void DelayBank<SampleType>::setSaturation(const float amount){
+    jassert(isPrepared);
+    feedbackChain.template getStage<2>().setAmount(amount);
+}
+
+template <typename SampleType>
+void DelayBank<SampleType>::setOutputShape(const OutputShape shape){
+    outputStage.setShape(shape);
+}
+
+template <typename SampleType>
+void DelayBank<SampleType>::clearDelayLines(){
+    delayMemory.clear();
+}
+
+//-----------------------------------------------------------------------------
+// Utility
+//-----------------------------------------------------------------------------
+template <typename SampleType>
+float DelayBank<SampleType>::convertMStoSample(const float time){
+    return (float) (0.001 * time * lastSampleRate);
+}
+
+template class DelayBank<float>;
+template class DelayBank<double>;
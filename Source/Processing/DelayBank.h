@@ -0,0 +1,90 @@
+/*
+  ==============================================================================
+
+    DelayBank.h
+    Created: 17 Oct 2026 5:48:53pm
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Delay.h"
+
+//==============================================================================
+/*
+    Many independent mono delay lines in one processor, for hosts that would
+    otherwise run one Delay per channel strip.
+
+    Each line is the Delay's single head: the rings are one planar
+    DelayMemory with a channel per line, read through the same interpolation
+    policies, and every repeat goes through the same feedback chain and
+    output stage. What differs is that each line has its own time, feedback
+    and mix, held structure-of-arrays in one GlideArray each, indexed by
+    line. The feedback path's settings and the output shape are shared.
+
+    Lines are processed in groups of CHANNELS_PER_GROUP. Blocks of at least
+    MIN_PARALLEL_SAMPLES across all lines share the groups out over a
+    work-stealing pool; smaller ones aren't worth waking the workers for
+    and run inline. There is no modulation, multi-tap, network or sleep.
+*/
+template <typename SampleType>
+class DelayBank {
+public:
+    // numWorkers < 0 uses one worker per core besides the audio thread
+    void prepareToPlay(double sampleRate, int samplesPerBlock, int numLines,
+                       DelayInterpolation interpolationType = DelayInterpolation::linear, int numWorkers = -1);
+    void reset();
+    
+    // Each channel of the block is one line, processed in place
+    void process(const juce::dsp::ProcessContextReplacing<SampleType>& context);
+    
+    void setDelayLength(const int line, const int delayTime_ms);
+    void setMix(const int line, const float mix);
+    void setFeedback(const int line, const float feedback);
+    
+    void setHighCut(const float frequency);
+    void setLowCut(const float frequency);
+    void setSaturation(const float amount);
+    void setOutputShape(const OutputShape shape);
+    
+    void clearDelayLines();
+private:
+    using GroupKernel = void (DelayBank::*)(int);
+    
+    bool isPrepared { false };
+    double lastSampleRate;
+    int numLines = 0;
+    int rampLength = 0;
+    int maxDelayLength = 0;
+    DelayInterpolation interpolation = DelayInterpolation::linear;
+    
+    // One ring per line, sharing the free-running write position
+    DelayMemory<SampleType> delayMemory;
+    juce::uint32 writePosition = 0;
+    
+    GlideArray delayLength, feedback, dryGain, wetGain;
+    
+    std::vector<ChannelState<SampleType>> lineStates;
+    DelayFeedbackChain<SampleType> feedbackChain;
+    OutputStage<SampleType> outputStage;
+    float lowCutFrequency = -1.0f;
+    
+    std::unique_ptr<WorkStealingPool> pool;
+    std::function<void(int)> groupTask;
+    GroupKernel groupKernel = nullptr;
+    juce::dsp::AudioBlock<SampleType>* currentBlock = nullptr;
+    int numGroups = 0;
+    
+    GroupKernel selectKernel();
+    template <typename Interpolator, bool isMasked>
+    void processGroup(int group);
+    void resetBrokenLines(int numSamples);
+    
+    //-----------------------------------------------------------------------------
+    // Utility
+    //-----------------------------------------------------------------------------
+    float convertMStoSample(const float time);
+};
@@ -0,0 +1,439 @@
+/*
+  ==============================================================================
+
+    DelayMemory.cpp
+    Created: 17 Oct 2026 2:31:56pm
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#include "DelayMemory.h"
+
+template <typename SampleType>
+DelayMemory<SampleType>::~DelayMemory(){
+    release();
+}
+
+template <typename SampleType>
+void DelayMemory<SampleType>::prepare(int numFrames, int numChannels, DelayBufferLayout layout, bool allocateLazily){
+    
+    jassert(juce::isPowerOfTwo(numFrames));
+    
+    release();
+    
+    const int simdWidth = (int) juce::dsp::SIMDRegister<SampleType>::SIMDNumElements;
+    
+    frameMask = (juce::uint32) numFrames - 1;
+    
+    // Paging only pays off when it defers allocation; an eager ring is one page,
+    // which keeps the page lookup out of the kernels' way
+    const int frameShift = (int) std::log2(numFrames);
+    pageShift = allocateLazily ? juce::jmin(maxPageShift, frameShift) : frameShift;
+    pageMask = (1u << pageShift) - 1;
+    numPages = numFrames >> pageShift;
+    
+    const int framesPerPage = 1 << pageShift;
+    
+    if (layout == DelayBufferLayout::interleaved){
+        // Pad frames to whole registers so every frame starts SIMD-aligned
+        frameStride = (numChannels + simdWidth - 1) / simdWidth * simdWidth;
+        channelStride = 1;
+        pageSize = framesPerPage * frameStride;
+    }
+    else {
+        frameStride = 1;
+        channelStride = framesPerPage;
+        pageSize = framesPerPage * numChannels;
+    }
+    
+    // Only lazy memory has uncommitted pages to stand in for
+    if (allocateLazily){
+        silentPage.calloc((size_t) pageSize);
+        discardPage.calloc((size_t) pageSize);
+    }
+    else {
+        silentPage.free();
+        discardPage.free();
+    }
+    
+    pages.clear();
+    pages.resize((size_t) numPages);
+    readPages.assign((size_t) numPages, silentPage.get());
+    writePages.assign((size_t) numPages, discardPage.get());
+    pageWritten.assign((size_t) numPages, false);
+    numInstalledPages.store(0);
+    
+    // The first pages are committed up front, so the first blocks don't
+    // depend on the pool, and the pool starts full
+    const int numEagerPages = allocateLazily ? juce::jmin(numPages, upfrontPages) : numPages;
+    for (int page = 0; page < numEagerPages; ++page){
+        commitPage(page);
+    }
+    
+    const int numSpares = allocateLazily ? juce::jmin(numPages - numEagerPages, maxSparePages) : 0;
+    spares.clear();
+    spares.resize((size_t) numSpares + 1);
+    spareFifo.setTotalSize(numSpares + 1);
+    refillSpares();
+    
+    reserve.clear();
+    reserve.resize(numSpares > 0 ? reservePages : 0);
+    for (auto& page : reserve){
+        page.calloc((size_t) pageSize);
+    }
+    numReserved = (int) reserve.size();
+    
+    released.clear();
+    released.resize((size_t) (numSpares > 0 ? numPages + 1 : 1));
+    releasedFifo.setTotalSize((int) released.size());
+    
+    lazy = numSpares > 0;
+    reach = numFrames;
+    isReleasedUpToSet = false;
+    
+    flushing = false;
+    watermarks.assign((size_t) juce::jmax(numChannels, frameStride), 0);
+    channelFlushing.assign(watermarks.size(), false);
+    
+    if (numSpares > 0){
+        allocatorThread = std::make_unique<juce::SharedResourcePointer<DelayPageAllocatorThread>>();
+        (*allocatorThread)->addTimeSliceClient(this);
+    }
+}
+
+template <typename SampleType>
+void DelayMemory<SampleType>::release(){
+    if (allocatorThread != nullptr){
+        (*allocatorThread)->removeTimeSliceClient(this);
+        allocatorThread.reset();
+    }
+    
+    pages.clear();
+    readPages.clear();
+    writePages.clear();
+    spares.clear();
+    spareFifo.reset();
+    released.clear();
+    releasedFifo.reset();
+    reserve.clear();
+    numReserved = 0;
+    numPages = 0;
+}
+
+template <typename SampleType>
+void DelayMemory<SampleType>::setNonRealtime(const bool isNonRealtime){
+    nonRealtime = isNonRealtime;
+}
+
+template <typename SampleType>
+void DelayMemory<SampleType>::setReach(const int numFrames){
+    reach = numFrames;
+}
+
+template <typename SampleType>
+void DelayMemory<SampleType>::prepareToWrite(juce::uint32 start, int numFrames){
+    
+    if (numFrames <= 0){
+        return;
+    }
+    
+    if (lazy){
+        releasePages(start, numFrames);
+    }
+    
+    // Installs any page the block reaches that has none yet, and remembers
+    // which pages hold data so clear() can skip the rest
+    const juce::uint32 firstPage = (start & frameMask) >> pageShift;
+    const juce::uint32 lastPage = ((start + (juce::uint32) numFrames - 1) & frameMask) >> pageShift;
+    
+    for (juce::uint32 page = firstPage;; page = (page + 1) % (juce::uint32) numPages){
+        if (writePages[page] == discardPage.get()){
+            installPage((int) page);
+        }
+        if (writePages[page] != discardPage.get()){
+            pageWritten[page] = true;
+        }
+        if (page == lastPage){
+            break;
+        }
+    }
+    
+    // A reserve page used while the pool was dry is replaced once it has spares again
+    while (numReserved < (int) reserve.size() && spareFifo.getNumReady() > 0){
+        int start1, size1, start2, size2;
+        spareFifo.prepareToRead(1, start1, size1, start2, size2);
+        reserve[(size_t) numReserved++].swapWith(spares[(size_t) start1]);
+        spareFifo.finishedRead(1);
+    }
+}
+
+template <typename SampleType>
+void DelayMemory<SampleType>::installPage(int page){
+    
+    int start1, size1, start2, size2;
+    spareFifo.prepareToRead(1, start1, size1, start2, size2);
+    
+    if (size1 > 0){
+        pages[(size_t) page].swapWith(spares[(size_t) start1]);
+        spareFifo.finishedRead(1);
+    }
+    else if (nonRealtime){
+        pages[(size_t) page].calloc((size_t) pageSize);
+    }
+    else if (numReserved > 0){
+        pages[(size_t) page].swapWith(reserve[(size_t) --numReserved]);
+    }
+    else {
+        // The allocator has fallen the whole pool and the reserve behind;
+        // this block's frames for the page are lost, and the next block tries again
+        jassertfalse;
+        return;
+    }
+    
+    readPages[(size_t) page] = pages[(size_t) page].get();
+    writePages[(size_t) page] = pages[(size_t) page].get();
+    numInstalledPages.fetch_add(1, std::memory_order_relaxed);
+}
+
+template <typename SampleType>
+void DelayMemory<SampleType>::releasePages(juce::uint32 start, int numFrames){
+    
+    const int framesPerPage = (int) pageMask + 1;
+    const juce::uint32 numRingFrames = frameMask + 1;
+    
+    // Frames more than a ring old share their pages with newer ones, so
+    // only the last ring's worth can have a page of their own to release
+    const juce::uint32 ringStart = (start + (juce::uint32) numFrames - numRingFrames + pageMask) & ~pageMask;
+    if (!isReleasedUpToSet || (juce::int32) (releasedUpTo - ringStart) < 0){
+        releasedUpTo = ringStart;
+        isReleasedUpToSet = true;
+    }
+    
+    // A longer reach leaves keepFrom behind releasedUpTo, and nothing more
+    // is released until the head has caught up
+    const juce::uint32 keepFrom = start - (juce::uint32) juce::jmin(reach, (int) numRingFrames);
+    while ((juce::int32) (keepFrom - releasedUpTo) >= framesPerPage){
+        releasePage((int) ((releasedUpTo & frameMask) >> pageShift));
+        releasedUpTo += (juce::uint32) framesPerPage;
+    }
+}
+
+template <typename SampleType>
+void DelayMemory<SampleType>::releasePage(int page){
+    
+    if (writePages[(size_t) page] == discardPage.get()){
+        return;
+    }
+    
+    int start1, size1, start2, size2;
+    releasedFifo.prepareToWrite(1, start1, size1, start2, size2);
+    if (size1 == 0){
+        return;
+    }
+    
+    // Reads of the page see silence from here on, as they would have before it was written
+    released[(size_t) start1].swapWith(pages[(size_t) page]);
+    releasedFifo.finishedWrite(1);
+    
+    readPages[(size_t) page] = silentPage.get();
+    writePages[(size_t) page] = discardPage.get();
+    pageWritten[(size_t) page] = false;
+    numInstalledPages.fetch_sub(1, std::memory_order_relaxed);
+}
+
+template <typename SampleType>
+void DelayMemory<SampleType>::clear(){
+    for (int page = 0; page < numPages; ++page){
+        if (pageWritten[page]){
+            juce::FloatVectorOperations::clear(writePages[page], pageSize);
+            pageWritten[page] = false;
+        }
+    }
+    flushing = false;
+    std::fill(channelFlushing.begin(), channelFlushing.end(), false);
+}
+
+// The stale frames are the ring's worth before the watermark, and each
+// sits in the slot of a frame up to a ring after it, so clearing the slots
+// from the watermark up to a ring past it leaves none. The write head
+// overwrites the slots it passes, so those are skipped.
+template <typename SampleType>
+void DelayMemory<SampleType>::startFlush(juce::uint32 watermark){
+    std::fill(watermarks.begin(), watermarks.end(), watermark);
+    std::fill(channelFlushing.begin(), channelFlushing.end(), true);
+    isWholeFlush = true;
+    flushCursor = watermark;
+    flushEnd = watermark + frameMask + 1;
+    flushing = true;
+}
+
+// The cursor goes back to the new watermark for every channel. Slots from
+// there on that other channels' flushes had already passed still only
+// hold their stale frames, so clearing them again is harmless.
+template <typename SampleType>
+void DelayMemory<SampleType>::startChannelFlush(int channel, juce::uint32 watermark){
+    watermarks[(size_t) channel] = watermark;
+    channelFlushing[(size_t) channel] = true;
+    isWholeFlush = isWholeFlush && flushing && std::all_of(watermarks.begin(), watermarks.end(),
+                                                           [watermark](juce::uint32 other){ return other == watermark; });
+    flushCursor = watermark;
+    flushEnd = watermark + frameMask + 1;
+    flushing = true;
+}
+
+template <typename SampleType>
+bool DelayMemory<SampleType>::continueFlush(juce::uint32 writePosition, int maxSamples){
+    
+    if (!flushing){
+        return true;
+    }
+    
+    if ((juce::int32) (writePosition - flushCursor) > 0){
+        flushCursor = writePosition;
+    }
+    
+    const int framesPerPage = (int) pageMask + 1;
+    int framesLeft = juce::jmax(1, maxSamples / (pageSize / framesPerPage));
+    
+    while (framesLeft > 0 && (juce::int32) (flushEnd - flushCursor) > 0){
+        const juce::uint32 index = flushCursor & frameMask;
+        const int page = (int) (index >> pageShift);
+        const int offset = (int) (index & pageMask);
+        int numFrames = juce::jmin(framesPerPage - offset, (int) (flushEnd - flushCursor));
+        
+        // Unwritten pages are silent already and cost nothing to pass
+        if (pageWritten[(size_t) page]){
+            numFrames = juce::jmin(numFrames, framesLeft);
+            clearFrames(page, offset, numFrames);
+            framesLeft -= numFrames;
+        }
+        flushCursor += (juce::uint32) numFrames;
+    }
+    
+    if ((juce::int32) (flushEnd - flushCursor) > 0){
+        return false;
+    }
+    flushing = false;
+    std::fill(channelFlushing.begin(), channelFlushing.end(), false);
+    return true;
+}
+
+template <typename SampleType>
+void DelayMemory<SampleType>::clearFrames(int page, int offset, int numFrames){
+    
+    // Each channel's stale slots end a ring past its own watermark
+    if (!isWholeFlush){
+        for (int channel = 0; channel < (int) channelFlushing.size(); ++channel){
+            if (channelFlushing[(size_t) channel]){
+                const juce::int32 numStale = (juce::int32) (watermarks[(size_t) channel] + frameMask + 1 - flushCursor);
+                clearChannelFrames(page, offset, juce::jlimit(0, numFrames, (int) numStale), channel);
+            }
+        }
+        return;
+    }
+    
+    if (frameStride > 1){
+        juce::FloatVectorOperations::clear(writePages[(size_t) page] + offset * frameStride, numFrames * frameStride);
+        return;
+    }
+    
+    const int numChannels = pageSize / channelStride;
+    for (int channel = 0; channel < numChannels; ++channel){
+        juce::FloatVectorOperations::clear(writePages[(size_t) page] + channel * channelStride + offset, numFrames);
+    }
+}
+
+template <typename SampleType>
+void DelayMemory<SampleType>::clearChannelFrames(int page, int offset, int numFrames, int channel){
+    SampleType* start = writePages[(size_t) page] + channel * channelStride + offset * frameStride;
+    if (frameStride == 1){
+        juce::FloatVectorOperations::clear(start, numFrames);
+        return;
+    }
+    
+    for (int frame = 0; frame < numFrames; ++frame){
+        start[frame * frameStride] = 0;
+    }
+}
+
+template <typename SampleType>
+void DelayMemory<SampleType>::commitPages(juce::uint32 start, int numFrames){
+    
+    // Counted rather than walked to a last page, as a whole ring from
+    // partway into a page ends in the page it started in
+    const int firstPage = (int) ((start & frameMask) >> pageShift);
+    const int numSpanned = juce::jmin(numPages, (int) (((start & pageMask) + (juce::uint32) numFrames + pageMask) >> pageShift));
+    
+    for (int index = 0; index < numSpanned; ++index){
+        const int page = (firstPage + index) % numPages;
+        if (writePages[(size_t) page] == discardPage.get()){
+            commitPage(page);
+        }
+    }
+    
+    // The write position is about to jump, so release starts over from it
+    isReleasedUpToSet = false;
+}
+
+// Installs a fresh page straight away, off the audio thread
+template <typename SampleType>
+void DelayMemory<SampleType>::commitPage(int page){
+    // calloc leaves zeroing to the OS, which hands out fresh pages already cleared
+    pages[(size_t) page].calloc((size_t) pageSize);
+    
+    jassert(juce::dsp::SIMDRegister<SampleType>::isSIMDAligned(pages[(size_t) page].get()));
+    
+    readPages[(size_t) page] = pages[(size_t) page].get();
+    writePages[(size_t) page] = pages[(size_t) page].get();
+    numInstalledPages.fetch_add(1, std::memory_order_relaxed);
+}
+
+template <typename SampleType>
+void DelayMemory<SampleType>::refillSpares(){
+    
+    // Spares beyond the pages still to be installed would never be used
+    int numWanted = juce::jmin(spareFifo.getFreeSpace(),
+                               numPages - numInstalledPages.load(std::memory_order_relaxed) - spareFifo.getNumReady());
+    
+    for (; numWanted > 0; --numWanted){
+        int start1, size1, start2, size2;
+        spareFifo.prepareToWrite(1, start1, size1, start2, size2);
+        spares[(size_t) start1].calloc((size_t) pageSize);
+        
+        jassert(juce::dsp::SIMDRegister<SampleType>::isSIMDAligned(spares[(size_t) start1].get()));
+        
+        spareFifo.finishedWrite(1);
+    }
+}
+
+template <typename SampleType>
+int DelayMemory<SampleType>::useTimeSlice(){
+    
+    // Released pages are cleared and reused as spares while the pool has
+    // room, and freed once it is full
+    int start1, size1, start2, size2;
+    releasedFifo.prepareToRead(releasedFifo.getNumReady(), start1, size1, start2, size2);
+    
+    for (auto [start, size] : { std::pair<int, int> { start1, size1 }, std::pair<int, int> { start2, size2 } }){
+        for (int slot = start; slot < start + size; ++slot){
+            auto& page = released[(size_t) slot];
+            
+            int spareStart1, spareSize1, spareStart2, spareSize2;
+            spareFifo.prepareToWrite(1, spareStart1, spareSize1, spareStart2, spareSize2);
+            if (spareSize1 > 0){
+                juce::FloatVectorOperations::clear(page.get(), pageSize);
+                spares[(size_t) spareStart1].swapWith(page);
+                spareFifo.finishedWrite(1);
+            }
+            page.free();
+        }
+    }
+    releasedFifo.finishedRead(size1 + size2);
+    
+    refillSpares();
+    return 10;
+}
+
+template class DelayMemory<float>;
+template class DelayMemory<double>;
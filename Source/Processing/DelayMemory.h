@@ -0,0 +1,206 @@
+/*
+  ==============================================================================
+
+    DelayMemory.h
+    Created: 17 Oct 2026 2:31:56pm
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+enum class DelayBufferLayout {
+    planar,      // one delay line per channel, processed one channel at a time
+    interleaved  // frames packed into SIMD registers, all channels processed together
+};
+
+// One thread allocates pages for every lazy delay memory, whatever its sample type
+struct DelayPageAllocatorThread : public juce::TimeSliceThread {
+    DelayPageAllocatorThread() : juce::TimeSliceThread("Delay Page Allocator") { startThread(); }
+    ~DelayPageAllocatorThread() override { stopThread(1000); }
+};
+
+//==============================================================================
+/*
+    Power-of-two ring of delay frames, stored in fixed-size pages.
+
+    Frames are addressed by the free-running write position; the ring masks
+    them internally. Until a page is committed, reads see a shared silent
+    page and writes land in a discard page, so the hot loop never branches
+    on whether memory exists.
+
+    In lazy mode only the first pages are committed up front. A shared
+    background thread keeps a pool of zeroed spare pages topped up, and the
+    audio thread installs a spare itself whenever the write head reaches a
+    page that has none, so it never waits on the allocator. Pages that fall
+    further behind the write head than the reads can reach are handed back
+    and recycled. A 60 s line set to half a second therefore only holds
+    half a second of pages, and clear() only touches pages that were
+    written. Should the pool run dry in realtime, the audio thread falls
+    back on a small reserve of committed pages of its own, topped up from
+    the pool once it recovers. Only with the reserve spent too are a
+    page's frames dropped until a spare arrives. When rendering offline
+    the pool can run dry, so a non-realtime writer allocates the page on
+    the spot instead. Eager memory is committed as a single page.
+*/
+template <typename SampleType>
+class DelayMemory : private juce::TimeSliceClient {
+public:
+    DelayMemory() = default;
+    ~DelayMemory() override;
+    
+    void prepare(int numFrames, int numChannels, DelayBufferLayout layout, bool allocateLazily);
+    void release();
+    
+    // Called on the audio thread before writing frames [start, start + numFrames)
+    void prepareToWrite(juce::uint32 start, int numFrames);
+    
+    // Offline, the writer may allocate pages itself rather than outrun the pool
+    void setNonRealtime(const bool isNonRealtime);
+    
+    // How far behind the write head the reads can go, in frames. In lazy
+    // mode, pages wholly older than that are released at the next write.
+    void setReach(const int numFrames);
+    
+    // Clears every written page at once, and ends any flush
+    void clear();
+    
+    // Amortised clearing. startFlush() makes every frame before watermark
+    // stale, and until the flush is done isStale() tells the reads to take
+    // those frames as silence. Each continueFlush() clears up to maxSamples
+    // more of the stale slots ahead of the write head, never one written
+    // since, and returns true once none are left. Writing carries on as usual.
+    // startChannelFlush() does the same for one channel and leaves the
+    // others playing; starting another flush mid-way folds the two together.
+    void startFlush(juce::uint32 watermark);
+    void startChannelFlush(int channel, juce::uint32 watermark);
+    bool continueFlush(juce::uint32 writePosition, int maxSamples);
+    bool isFlushing() const { return flushing; }
+    bool isStale(int channel, juce::uint32 frame) const {
+        return channelFlushing[(size_t) channel] && (juce::int32) (frame - watermarks[(size_t) channel]) < 0;
+    }
+    
+    // Samples across all pages, committed or not
+    int getNumSamples() const { return numPages * pageSize; }
+    
+    // Planar layout only
+    SampleType getSample(int channel, juce::uint32 frame) const {
+        const juce::uint32 index = frame & frameMask;
+        return readPages[index >> pageShift][channel * channelStride + (int) (index & pageMask)];
+    }
+    
+    void setSample(int channel, juce::uint32 frame, SampleType value){
+        const juce::uint32 index = frame & frameMask;
+        writePages[index >> pageShift][channel * channelStride + (int) (index & pageMask)] = value;
+    }
+    
+    // A ring that fits in one page is plain contiguous memory, so callers can
+    // skip the page lookup with the accessors below
+    bool isContiguous() const { return numPages == 1; }
+    
+    SampleType getContiguousSample(int channel, juce::uint32 frame) const {
+        return readPages[0][channel * channelStride + (int) (frame & frameMask)];
+    }
+    
+    void setContiguousSample(int channel, juce::uint32 frame, SampleType value){
+        writePages[0][channel * channelStride + (int) (frame & frameMask)] = value;
+    }
+    
+    // Interleaved layout only: a whole frame, padded to a multiple of the SIMD width
+    const SampleType* getFrame(juce::uint32 frame) const {
+        const juce::uint32 index = frame & frameMask;
+        return readPages[index >> pageShift] + (int) (index & pageMask) * frameStride;
+    }
+    
+    SampleType* getWriteFrame(juce::uint32 frame){
+        const juce::uint32 index = frame & frameMask;
+        return writePages[index >> pageShift] + (int) (index & pageMask) * frameStride;
+    }
+    
+    int getFrameStride() const { return frameStride; }
+    
+    // Either layout, for snapshots rather than kernels
+    SampleType readSample(int channel, juce::uint32 frame) const {
+        const juce::uint32 index = frame & frameMask;
+        return readPages[index >> pageShift][channel * channelStride + (int) (index & pageMask) * frameStride];
+    }
+    
+    void writeSample(int channel, juce::uint32 frame, SampleType value){
+        const juce::uint32 index = frame & frameMask;
+        writePages[index >> pageShift][channel * channelStride + (int) (index & pageMask) * frameStride] = value;
+        pageWritten[index >> pageShift] = writePages[index >> pageShift] != discardPage.get();
+    }
+    
+    // Commits the pages holding numFrames frames from start on the calling
+    // thread, so a restored snapshot doesn't land in the discard page. The
+    // rest stay uncommitted until written. Not for the audio thread.
+    void commitPages(juce::uint32 start, int numFrames);
+
+private:
+    static constexpr int maxPageShift = 12;  // 4096 frames per page
+    static constexpr int upfrontPages = 8;
+    static constexpr int maxSparePages = 16;  // over 0.15 s of headroom even at 384 kHz
+    static constexpr int reservePages = 2;
+    
+    juce::uint32 frameMask = 0;
+    juce::uint32 pageMask = 0;
+    int pageShift = 0;
+    int numPages = 0;
+    int pageSize = 0;        // samples per page
+    int channelStride = 0;
+    int frameStride = 0;
+    
+    // Owned by the audio thread once installed
+    std::vector<juce::HeapBlock<SampleType>> pages;
+    
+    // The audio thread's page tables. Plain pointers so the compiler can keep
+    // lookups in registers; pages are installed at block start.
+    std::vector<SampleType*> readPages, writePages;
+    std::vector<bool> pageWritten;
+    
+    // The slots of frames from flushCursor up to flushEnd may still hold
+    // frames from before their channel's watermark. The per-channel state
+    // has a slot for every lane of a padded frame.
+    bool flushing = false;
+    bool isWholeFlush = false;  // every channel shares one watermark
+    std::vector<juce::uint32> watermarks;
+    std::vector<bool> channelFlushing;
+    juce::uint32 flushCursor = 0;
+    juce::uint32 flushEnd = 0;
+    
+    juce::HeapBlock<SampleType> silentPage, discardPage;
+    
+    // Lazy commit. Spare pages pass from the allocator thread to the audio
+    // thread through one FIFO and released pages come back through the
+    // other, each slot's block swapped out by the reader.
+    std::unique_ptr<juce::SharedResourcePointer<DelayPageAllocatorThread>> allocatorThread;
+    std::vector<juce::HeapBlock<SampleType>> spares, released;
+    juce::AbstractFifo spareFifo { 1 }, releasedFifo { 1 };
+    std::atomic<int> numInstalledPages { 0 };
+    
+    // Zeroed pages the audio thread keeps for when the FIFO is empty
+    std::vector<juce::HeapBlock<SampleType>> reserve;
+    int numReserved = 0;
+    bool lazy = false;
+    bool nonRealtime = false;
+    
+    // Frames before releasedUpTo have had their pages released, unless
+    // that is unset after a prepare, clear or restore
+    int reach = 0;
+    juce::uint32 releasedUpTo = 0;
+    bool isReleasedUpToSet = false;
+    
+    void installPage(int page);
+    void commitPage(int page);
+    void releasePages(juce::uint32 start, int numFrames);
+    void releasePage(int page);
+    void clearFrames(int page, int offset, int numFrames);
+    void clearChannelFrames(int page, int offset, int numFrames, int channel);
+    void refillSpares();
+    int useTimeSlice() override;
+    
+    JUCE_DECLARE_NON_COPYABLE (DelayMemory)
+};
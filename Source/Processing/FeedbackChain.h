@@ -0,0 +1,183 @@
+/*
+  ==============================================================================
+
+    FeedbackChain.h
+    Created: 17 Oct 2026 9:02:17pm
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <limits>
+#include <tuple>
+#define FEEDBACK_HIGH_CUT_OFF_HZ 20000.0f  // at or above, the high cut passes everything
+#define FEEDBACK_LOW_CUT_OFF_HZ 20.0f  // at or below, the low cut passes everything
+
+//==============================================================================
+/*
+    Stages for the feedback path, applied to every repeat on its way back
+    into the delay memory.
+
+    Like the interpolation policies, each stage's process() is a template on
+    the value type, so the same code serves the planar kernel (one sample)
+    and the interleaved kernel (a SIMDRegister of channels). `state` is the
+    stage's memory for that channel or register; stateless stages ignore it.
+    Settings are plain coefficients, set between blocks, and every stage has
+    a setting at which it passes its input through exactly.
+*/
+namespace FeedbackStages {
+
+template <typename SampleType>
+SampleType clamp(SampleType value, SampleType lowest, SampleType highest){
+    return juce::jlimit(lowest, highest, value);
+}
+
+template <typename SampleType>
+juce::dsp::SIMDRegister<SampleType> clamp(juce::dsp::SIMDRegister<SampleType> value, SampleType lowest, SampleType highest){
+    using SIMDSample = juce::dsp::SIMDRegister<SampleType>;
+    return SIMDSample::min(SIMDSample::max(value, SIMDSample::expand(lowest)), SIMDSample::expand(highest));
+}
+
+// One-pole low-pass: each repeat comes back a little darker, like tape
+template <typename SampleType>
+struct HighCut {
+    SampleType pole = 0;
+    
+    void setCutoff(double sampleRate, float frequency){
+        pole = frequency >= FEEDBACK_HIGH_CUT_OFF_HZ ? (SampleType) 0
+                                                     : (SampleType) std::exp(-juce::MathConstants<double>::twoPi * frequency / sampleRate);
+    }
+    
+    template <typename Value>
+    Value process(Value input, Value& state) const {
+        state = input + (state - input) * pole;
+        return state;
+    }
+};
+
+// One-pole high-pass, the input less its low-passed self, so bass doesn't build up.
+// Off, the pole of 1 holds the state where it is, so it only passes the
+// input untouched once its state is zeroed, as the chain's resetStage() does.
+template <typename SampleType>
+struct LowCut {
+    SampleType pole = 1;
+    
+    void setCutoff(double sampleRate, float frequency){
+        pole = frequency <= FEEDBACK_LOW_CUT_OFF_HZ ? (SampleType) 1
+                                                    : (SampleType) std::exp(-juce::MathConstants<double>::twoPi * frequency / sampleRate);
+    }
+    
+    template <typename Value>
+    Value process(Value input, Value& state) const {
+        state = input + (state - input) * pole;
+        return input - state;
+    }
+};
+
+// Cubic soft clip, x - x^3 / (3 limit^2) below the limit, flat above it.
+// Unity gain for quiet repeats, and never louder than its input, so it can
+// only take gain out of the loop.
+template <typename SampleType>
+struct Saturator {
+    SampleType limit = std::numeric_limits<SampleType>::infinity();
+    SampleType cubic = 0;
+    
+    // 0 is off; from there up to 1 the ceiling falls from 1 to a quarter
+    void setAmount(float amount){
+        if (amount <= 0.0f){
+            limit = std::numeric_limits<SampleType>::infinity();
+            cubic = 0;
+            return;
+        }
+        const float ceiling = 1.0f - 0.75f * juce::jmin(1.0f, amount);
+        limit = (SampleType) (1.5f * ceiling);
+        cubic = (SampleType) 1 / (3 * limit * limit);
+    }
+    
+    template <typename Value>
+    Value process(Value input, Value&) const {
+        // Off, the limit is infinite and cubic zero. Multiplying by cubic
+        // first keeps the cube of a huge repeat from overflowing to inf * 0.
+        const Value clipped = clamp(input, -limit, limit);
+        return clipped - clipped * cubic * clipped * clipped;
+    }
+};
+
+}
+
+//==============================================================================
+/*
+    A fixed sequence of feedback stages, composed at compile time.
+
+    process() runs a value through every stage in order as one inlined
+    expression: no virtual calls, and no branch on which stages are on, since
+    a stage that is off is just an identity. States are held stage by stage,
+    each stage's run of them spanning every channel, padded to whole SIMD
+    registers. Channel c's state is lane c, so the planar kernel indexes by
+    channel and the interleaved kernel by register over the same memory.
+*/
+template <typename SampleType, template <typename> class... Stages>
+class FeedbackChain {
+public:
+    using SIMDSample = juce::dsp::SIMDRegister<SampleType>;
+    
+    void prepare(int numChannels){
+        registersPerStage = (numChannels + (int) SIMDSample::SIMDNumElements - 1) / (int) SIMDSample::SIMDNumElements;
+        states.assign((size_t) (sizeof...(Stages) * registersPerStage), SIMDSample::expand(0.0f));
+        savedStates = states;
+    }
+    
+    void reset(){
+        std::fill(states.begin(), states.end(), SIMDSample::expand(0.0f));
+    }
+    
+    // Zeroes one stage's states on every channel
+    template <size_t index>
+    void resetStage(){
+        std::fill_n(states.begin() + (std::ptrdiff_t) (index * (size_t) registersPerStage), registersPerStage, SIMDSample::expand(0.0f));
+    }
+    
+    void resetChannel(int channel){
+        SampleType* laneStates = reinterpret_cast<SampleType*>(states.data()) + channel;
+        for (size_t stage = 0; stage < sizeof...(Stages); ++stage){
+            laneStates[stage * (size_t) registersPerStage * SIMDSample::SIMDNumElements] = 0;
+        }
+    }
+    
+    // For running a block through twice, as a crossfade does, with the
+    // second pass starting from the same states as the first
+    void saveStates(){ std::copy(states.begin(), states.end(), savedStates.begin()); }
+    void restoreStates(){ std::copy(savedStates.begin(), savedStates.end(), states.begin()); }
+    
+    template <size_t index>
+    auto& getStage() { return std::get<index>(stages); }
+    
+    // Planar: one channel's sample
+    SampleType process(SampleType input, int channel){
+        SampleType* laneStates = reinterpret_cast<SampleType*>(states.data()) + channel;
+        return processStages(input, laneStates, registersPerStage * (int) SIMDSample::SIMDNumElements, std::index_sequence_for<Stages<SampleType>...>());
+    }
+    
+    // Interleaved: one register of channels
+    SIMDSample process(SIMDSample input, int reg){
+        return processStages(input, states.data() + reg, registersPerStage, std::index_sequence_for<Stages<SampleType>...>());
+    }
+private:
+    std::tuple<Stages<SampleType>...> stages;
+    std::vector<SIMDSample> states;  // [stage][register]
+    std::vector<SIMDSample> savedStates;
+    int registersPerStage = 0;
+    
+    template <typename Value, size_t... index>
+    Value processStages(Value value, Value* stageStates, int stride, std::index_sequence<index...>){
+        ((value = std::get<index>(stages).process(value, stageStates[index * stride])), ...);
+        return value;
+    }
+};
+
+// The delay's feedback path: darken, thin, then saturate
+template <typename SampleType>
+using DelayFeedbackChain = FeedbackChain<SampleType, FeedbackStages::HighCut, FeedbackStages::LowCut, FeedbackStages::Saturator>;
@@ -0,0 +1,285 @@
+/*
+  ==============================================================================
+
+    FeedbackNetwork.cpp
+    Created: 17 Oct 2026 8:14:05pm
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#include "FeedbackNetwork.h"
+#include "Interpolation.h"
+
+template <typename SampleType>
+void FeedbackNetwork<SampleType>::prepare(double sampleRate, int samplesPerBlock, int maxLength){
+    this->maxLength = maxLength;
+    rampLength = juce::jmax(1, (int) (sampleRate * 0.02));
+    
+    // One eager page rather than lazy ones, as the network may run faster
+    // than the page allocator commits when rendering offline. The OS zeroes
+    // the calloc'd ring as it is touched, so lines the network never writes
+    // cost no memory.
+    memory.prepare(juce::nextPowerOfTwo(maxLength + 2), FDN_MAX_LINES, DelayBufferLayout::planar, false);
+    
+    registersPerLine = (samplesPerBlock + (int) SIMDSample::SIMDNumElements - 1) / (int) SIMDSample::SIMDNumElements;
+    lineBlock.assign((size_t) (FDN_MAX_LINES * registersPerLine), SIMDSample::expand(0.0f));
+    
+    // Neighbouring ranks are paired, and the pairs taken in bit-reversed
+    // order, so any power-of-two prefix of the lines spans the whole spread
+    // and stereo pairs of lines have nearly equal lengths
+    const int numPairBits = (int) std::log2(FDN_MAX_LINES / 2);
+    for (int line = 0; line < FDN_MAX_LINES; ++line){
+        int pair = line >> 1;
+        int reversed = 0;
+        for (int bit = 0; bit < numPairBits; ++bit, pair >>= 1){
+            reversed = (reversed << 1) | (pair & 1);
+        }
+        lineOfRank[reversed * 2 + (line & 1)] = line;
+    }
+    
+    lengths.resize(FDN_MAX_LINES);
+    reset();
+}
+
+template <typename SampleType>
+void FeedbackNetwork<SampleType>::reset(){
+    // Lines start at their first length after a reset rather than gliding to it
+    lengths.snap();
+    lengths.unset();
+    longestTarget = -1.0f;
+    clear();
+}
+
+template <typename SampleType>
+bool FeedbackNetwork<SampleType>::isValidSize(int numLines){
+    return numLines == 4 || numLines == 8 || numLines == 16;
+}
+
+template <typename SampleType>
+void FeedbackNetwork<SampleType>::setDelayLength(float delaySamples){
+    
+    // Rounding up to a prime must stay within reach
+    const float longest = juce::jlimit(1.0f, (float) juce::jmax(1, maxLength - FDN_PRIME_SLACK), delaySamples);
+    if (longest == longestTarget){
+        return;
+    }
+    longestTarget = longest;
+    
+    // Shortest first, each a prime above the last, so every length is
+    // distinct and any two are coprime
+    int previous = 1;
+    for (int rank = FDN_MAX_LINES - 1; rank >= 0; --rank){
+        const float ratio = std::pow(FDN_LENGTH_SPREAD, (float) rank / (float) FDN_MAX_LINES);
+        const int length = juce::jmin(maxLength - 2, nextPrime(juce::jmax(previous + 1, juce::roundToInt(longest * ratio))));
+        lengths.setTarget(lineOfRank[rank], (float) length, rampLength);
+        previous = length;
+    }
+}
+
+template <typename SampleType>
+void FeedbackNetwork<SampleType>::advance(int numSamples){
+    lengths.advance(FDN_MAX_LINES, numSamples);
+}
+
+template <typename SampleType>
+float FeedbackNetwork<SampleType>::getLongestDelay() const {
+    float longest = 0.0f;
+    for (int line = 0; line < FDN_MAX_LINES; ++line){
+        longest = juce::jmax(longest, lengths.getCurrent(line), lengths.getTarget(line));
+    }
+    return longest;
+}
+
+template <typename SampleType>
+void FeedbackNetwork<SampleType>::prepareToWrite(juce::uint32 position, int numSamples){
+    memory.prepareToWrite(position, numSamples);
+}
+
+template <typename SampleType>
+SampleType FeedbackNetwork<SampleType>::process(const juce::dsp::AudioBlock<SampleType>& block, juce::AudioBuffer<SampleType>& delayed,
+                                                int numLines, juce::uint32 position, const ParameterRamp<SampleType>& feedbackRamp,
+                                                DelayFeedbackChain<SampleType>& chain){
+    
+    jassert(isValidSize(numLines));
+    
+    const int numSamples = (int) block.getNumSamples();
+    const int numChannels = juce::jmin((int) block.getNumChannels(), delayed.getNumChannels());
+    const float* lengthStart = lengths.getStart();
+    const float* lengthIncrement = lengths.getIncrement();
+    
+    silenceDroppedLines(numLines, position, numSamples);
+    
+    // Lengths glide linearly across the block, so the shortest is at one end
+    float shortest = (float) maxLength;
+    for (int line = 0; line < numLines; ++line){
+        shortest = juce::jmin(shortest, lengthStart[line], lengthStart[line] + lengthIncrement[line] * (float) (numSamples - 1));
+    }
+    const int chunkSize = juce::jmax(1, (int) shortest);
+    
+    // The Hadamard matrix's rows have a norm of sqrt(N); scaled down, it is
+    // orthogonal and the loop gain is the feedback alone
+    const SampleType matrixGain = (SampleType) (1.0 / std::sqrt((double) numLines));
+    
+    // Mid-flush, anything from before the watermark reads as silence
+    const bool isMasked = memory.isFlushing();
+    
+    SampleType writtenPeak = 0;
+    
+    for (int chunkStart = 0; chunkStart < numSamples; chunkStart += chunkSize){
+        const int chunkLength = juce::jmin(chunkSize, numSamples - chunkStart);
+        const int numRegisters = (chunkLength + (int) SIMDSample::SIMDNumElements - 1) / (int) SIMDSample::SIMDNumElements;
+        
+        for (int line = 0; line < numLines; ++line){
+            SampleType* row = getRow(line);
+            SampleType unusedState = 0;
+            
+            for (int sample = 0; sample < chunkLength; ++sample){
+                const int blockSample = chunkStart + sample;
+                const juce::uint32 framePosition = position + (juce::uint32) blockSample;
+                auto tap = [this, line, framePosition, isMasked](int delay){
+                    const juce::uint32 frame = framePosition - (juce::uint32) delay;
+                    if (isMasked && memory.isStale(line, frame)){
+                        return (SampleType) 0;
+                    }
+                    return memory.getContiguousSample(line, frame);
+                };
+                row[sample] = Interpolation::Linear::read(tap, lengthStart[line] + lengthIncrement[line] * (float) blockSample, unusedState);
+            }
+        }
+        
+        // Each channel hears its own lines as they come out, before they are mixed
+        for (int channel = 0; channel < numChannels; ++channel){
+            SampleType* channelDelayed = delayed.getWritePointer(channel) + chunkStart;
+            
+            if (numChannels > numLines){
+                juce::FloatVectorOperations::copy(channelDelayed, getRow(channel % numLines), chunkLength);
+                continue;
+            }
+            
+            const int numChannelLines = (numLines - channel + numChannels - 1) / numChannels;
+            const SampleType outputGain = (SampleType) (1.0 / std::sqrt((double) numChannelLines));
+            juce::FloatVectorOperations::copyWithMultiply(channelDelayed, getRow(channel), outputGain, chunkLength);
+            for (int line = channel + numChannels; line < numLines; line += numChannels){
+                juce::FloatVectorOperations::addWithMultiply(channelDelayed, getRow(line), outputGain, chunkLength);
+            }
+        }
+        
+        fastWalshHadamard(numLines, numRegisters);
+        
+        for (int line = 0; line < numLines; ++line){
+            SampleType* row = getRow(line);
+            
+            for (int sample = 0; sample < chunkLength; ++sample){
+                row[sample] = chain.process(row[sample] * feedbackRamp[chunkStart + sample] * matrixGain, line);
+            }
+            
+            if (numChannels > numLines){
+                for (int channel = line; channel < numChannels; channel += numLines){
+                    juce::FloatVectorOperations::add(row, block.getChannelPointer((size_t) channel) + chunkStart, chunkLength);
+                }
+            }
+            else {
+                juce::FloatVectorOperations::add(row, block.getChannelPointer((size_t) (line % numChannels)) + chunkStart, chunkLength);
+            }
+            
+            for (int sample = 0; sample < chunkLength; ++sample){
+                memory.setContiguousSample(line, position + (juce::uint32) (chunkStart + sample), row[sample]);
+            }
+            
+            const auto range = juce::FloatVectorOperations::findMinAndMax(row, chunkLength);
+            writtenPeak = juce::jmax(writtenPeak, -range.getStart(), range.getEnd());
+        }
+    }
+    
+    return writtenPeak;
+}
+
+// In place over the chunk's rows. Every stage pairs whole rows, so the
+// butterflies are register-wide adds and subtracts with no shuffling.
+template <typename SampleType>
+void FeedbackNetwork<SampleType>::fastWalshHadamard(int numLines, int numRegisters){
+    for (int half = 1; half < numLines; half *= 2){
+        for (int first = 0; first < numLines; first += 2 * half){
+            for (int line = first; line < first + half; ++line){
+                SIMDSample* upper = lineBlock.data() + line * registersPerLine;
+                SIMDSample* lower = lineBlock.data() + (line + half) * registersPerLine;
+                
+                for (int reg = 0; reg < numRegisters; ++reg){
+                    const SIMDSample sum = upper[reg] + lower[reg];
+                    lower[reg] = upper[reg] - lower[reg];
+                    upper[reg] = sum;
+                }
+            }
+        }
+    }
+}
+
+template <typename SampleType>
+void FeedbackNetwork<SampleType>::silenceDroppedLines(int numLines, juce::uint32 position, int numSamples){
+    
+    if (numLines >= numDirtyLines){
+        numDirtyLines = numLines;
+        zeroedFrames = 0;
+        return;
+    }
+    
+    for (int line = numLines; line < numDirtyLines; ++line){
+        for (int sample = 0; sample < numSamples; ++sample){
+            memory.setContiguousSample(line, position + (juce::uint32) sample, 0);
+        }
+    }
+    
+    zeroedFrames += numSamples;
+    if (zeroedFrames >= maxLength){
+        numDirtyLines = numLines;
+        zeroedFrames = 0;
+    }
+}
+
+template <typename SampleType>
+void FeedbackNetwork<SampleType>::clear(){
+    memory.clear();
+    numDirtyLines = 0;
+    zeroedFrames = 0;
+}
+
+template <typename SampleType>
+void FeedbackNetwork<SampleType>::startFlush(juce::uint32 watermark){
+    memory.startFlush(watermark);
+}
+
+template <typename SampleType>
+bool FeedbackNetwork<SampleType>::continueFlush(juce::uint32 writePosition, int maxSamples){
+    if (!memory.isFlushing()){
+        return true;
+    }
+    if (!memory.continueFlush(writePosition, maxSamples)){
+        return false;
+    }
+    numDirtyLines = 0;
+    zeroedFrames = 0;
+    return true;
+}
+
+template <typename SampleType>
+int FeedbackNetwork<SampleType>::nextPrime(int value){
+    if (value <= 2){
+        return 2;
+    }
+    for (int candidate = value | 1;; candidate += 2){
+        bool isPrime = true;
+        for (int divisor = 3; divisor * divisor <= candidate; divisor += 2){
+            if (candidate % divisor == 0){
+                isPrime = false;
+                break;
+            }
+        }
+        if (isPrime){
+            return candidate;
+        }
+    }
+}
+
+template class FeedbackNetwork<float>;
+template class FeedbackNetwork<double>;
@@ -0,0 +1,104 @@
+/*
+  ==============================================================================
+
+    FeedbackNetwork.h
+    Created: 17 Oct 2026 8:14:05pm
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DelayMemory.h"
+#include "GlideArray.h"
+#include "ParameterRamp.h"
+#include "FeedbackChain.h"
+#define FDN_MAX_LINES 16
+#define FDN_MAX_DELAY_SECONDS 2.0
+#define FDN_LENGTH_SPREAD 0.5f  // the shortest line's length relative to the longest
+#define FDN_PRIME_SLACK 1024  // headroom above the longest target for rounding up to a prime
+
+//==============================================================================
+/*
+    Feedback delay network: 4, 8 or 16 internal lines whose outputs are mixed
+    back into every line's input through a normalised Hadamard matrix, for
+    dense, diffuse echoes.
+
+    The delay time sets the longest line; the others are spread down to
+    FDN_LENGTH_SPREAD of it, each rounded to a distinct prime so no two lines'
+    echoes ever line up. Lengths are fixed per line whatever the network's
+    size, and ordered so that the first 4 or 8 lines are spread as evenly as
+    all 16, which lets a change of size crossfade between two sizes over the
+    same memory.
+
+    No line is shorter than the block it is processed in, so a chunk of up to
+    the shortest line's length only reads frames written before it. Each
+    chunk is read line by line into a row of registers, mixed by the fast
+    Walsh-Hadamard transform as whole-row butterflies, one register of
+    consecutive samples at a time, and written back. The mix costs
+    N log2 N adds per sample instead of the N * N of a matrix multiply.
+
+    Channel c feeds, and is fed by, the lines l with l % numChannels == c.
+    With more channels than lines, line l takes the sum of the channels
+    c % numLines == l and channel c hears line c % numLines.
+*/
+template <typename SampleType>
+class FeedbackNetwork {
+public:
+    // maxLength is the furthest back any line may read, in samples
+    void prepare(double sampleRate, int samplesPerBlock, int maxLength);
+    void reset();
+    
+    static bool isValidSize(int numLines);
+    
+    void setDelayLength(float delaySamples);
+    
+    // Called once per block, before process()
+    void advance(int numSamples);
+    void prepareToWrite(juce::uint32 position, int numSamples);
+    
+    // Runs the first numLines lines over the block, writing each channel's
+    // share of the network's output to delayed. The mixed lines pass through
+    // the chain, a lane per line, on their way back in. Returns the loudest
+    // sample written to the lines.
+    SampleType process(const juce::dsp::AudioBlock<SampleType>& block, juce::AudioBuffer<SampleType>& delayed,
+                       int numLines, juce::uint32 position, const ParameterRamp<SampleType>& feedbackRamp,
+                       DelayFeedbackChain<SampleType>& chain);
+    
+    void clear();
+    
+    // The lines' memory flushes as DelayMemory's does, with the same watermark for every line
+    void startFlush(juce::uint32 watermark);
+    bool continueFlush(juce::uint32 writePosition, int maxSamples);
+    bool isFlushing() const { return memory.isFlushing(); }
+    int getMemorySize() const { return memory.getNumSamples(); }
+    
+    // The furthest back any line reads until its glide is done
+    float getLongestDelay() const;
+private:
+    using SIMDSample = juce::dsp::SIMDRegister<SampleType>;
+    
+    DelayMemory<SampleType> memory;
+    int maxLength = 0;
+    int rampLength = 0;
+    
+    GlideArray lengths;  // per line, in samples
+    float longestTarget = -1.0f;
+    int lineOfRank[FDN_MAX_LINES];  // the lines from longest to shortest
+    
+    std::vector<SIMDSample> lineBlock;  // [line][register] rows of the chunk being mixed
+    int registersPerLine = 0;
+    
+    // Lines dropped by a smaller network are written with silence for a
+    // whole reach, so they come back clear
+    int numDirtyLines = 0;
+    int zeroedFrames = 0;
+    
+    SampleType* getRow(int line) { return reinterpret_cast<SampleType*>(lineBlock.data() + line * registersPerLine); }
+    void fastWalshHadamard(int numLines, int numRegisters);
+    void silenceDroppedLines(int numLines, juce::uint32 position, int numSamples);
+    
+    static int nextPrime(int value);
+};
@@ -0,0 +1,102 @@
+/*
+  ==============================================================================
+
+    GlideArray.h
+    Created: 17 Oct 2026 5:14:22pm
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+    One parameter for many voices, stored structure-of-arrays.
+
+    Each entry glides linearly to its target over its own ramp, except the
+    first target after unset(), which applies immediately. advance()
+    is called once per block and hands the kernels a start value and a
+    per-sample increment, so an entry's value at sample s of the block is
+    start[index] + increment[index] * s and a sweep over all entries reads
+    contiguous memory.
+*/
+class GlideArray {
+public:
+    void resize(size_t size){
+        for (auto* values : { &current, &target, &step, &start, &increment }){
+            values->assign(size, 0.0f);
+        }
+        remaining.assign(size, 0);
+        isUnset.assign(size, true);
+    }
+    
+    float getTarget(int index) const { return target[index]; }
+    float getCurrent(int index) const { return current[index]; }
+    
+    // A ramp length of zero jumps straight to the value
+    void setTarget(int index, float value, int rampLength){
+        if (isUnset[index]){
+            rampLength = 0;
+            isUnset[index] = false;
+        }
+        
+        target[index] = value;
+        remaining[index] = juce::jmax(0, rampLength);
+        
+        if (rampLength <= 0){
+            current[index] = value;
+            step[index] = 0.0f;
+            return;
+        }
+        step[index] = (value - current[index]) / (float) rampLength;
+    }
+    
+    void advanceEntry(int index, int numSamples){
+        start[index] = current[index];
+        
+        if (remaining[index] <= 0){
+            increment[index] = 0.0f;
+        }
+        else if (remaining[index] > numSamples){
+            increment[index] = step[index];
+            current[index] += step[index] * (float) numSamples;
+            remaining[index] -= numSamples;
+        }
+        else {
+            // Land exactly on the target by the end of this block
+            increment[index] = (target[index] - current[index]) / (float) numSamples;
+            current[index] = target[index];
+            remaining[index] = 0;
+        }
+    }
+    
+    // Advances entries [0, numEntries) by one block
+    void advance(int numEntries, int numSamples){
+        for (int index = 0; index < numEntries; ++index){
+            advanceEntry(index, numSamples);
+        }
+    }
+    
+    bool isSet(int index) const { return !isUnset[index]; }
+    void unset(int index){ isUnset[index] = true; }
+    void unset(){ std::fill(isUnset.begin(), isUnset.end(), true); }
+    
+    void snap(){
+        current = target;
+        start = target;
+        std::fill(step.begin(), step.end(), 0.0f);
+        std::fill(increment.begin(), increment.end(), 0.0f);
+        std::fill(remaining.begin(), remaining.end(), 0);
+    }
+    
+    const float* getStart() const { return start.data(); }
+    const float* getIncrement() const { return increment.data(); }
+    
+private:
+    std::vector<float> current, target, step, start, increment;
+    std::vector<int> remaining;
+    std::vector<bool> isUnset;
+};
@@ -0,0 +1,116 @@
+/*
+  ==============================================================================
+
+    Interpolation.h
+    Created: 17 Oct 2026 10:12:48am
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+enum class DelayInterpolation {
+    linear,
+    cubicHermite,
+    lagrange3,
+    thiran
+};
+
+//==============================================================================
+/*
+    Fractional-delay read policies for the delay line.
+
+    Each policy reads a delay of `delay` samples (whole part plus fraction)
+    through `tap(n)`, which returns the sample written n frames ago. The value
+    type is a template parameter so the same policy serves the planar kernel
+    (float) and the interleaved kernel (SIMDRegister<float>). `state` is
+    per-channel memory for recursive policies and is untouched by the others.
+    minimumDelay is the shortest delay a policy can read without touching the
+    slot that is about to be written.
+*/
+namespace Interpolation {
+
+struct Linear {
+    static constexpr float minimumDelay = 1.0f;
+
+    template <typename SampleType, typename Tap>
+    static SampleType read(Tap&& tap, float delay, SampleType&){
+        const int whole = (int) delay;
+        const float fraction = delay - (float) whole;
+
+        const SampleType x0 = tap(whole);
+        const SampleType x1 = tap(whole + 1);
+
+        return x0 + (x1 - x0) * fraction;
+    }
+};
+
+struct CubicHermite {
+    static constexpr float minimumDelay = 2.0f;
+
+    template <typename SampleType, typename Tap>
+    static SampleType read(Tap&& tap, float delay, SampleType&){
+        const int whole = (int) delay;
+        const float t = delay - (float) whole;
+
+        const SampleType xm1 = tap(whole - 1);
+        const SampleType x0 = tap(whole);
+        const SampleType x1 = tap(whole + 1);
+        const SampleType x2 = tap(whole + 2);
+
+        const SampleType c1 = (x1 - xm1) * 0.5f;
+        const SampleType c2 = xm1 - x0 * 2.5f + x1 * 2.0f - x2 * 0.5f;
+        const SampleType c3 = (x2 - xm1) * 0.5f + (x0 - x1) * 1.5f;
+
+        return ((c3 * t + c2) * t + c1) * t + x0;
+    }
+};
+
+struct Lagrange3 {
+    static constexpr float minimumDelay = 2.0f;
+
+    template <typename SampleType, typename Tap>
+    static SampleType read(Tap&& tap, float delay, SampleType&){
+        const int whole = (int) delay;
+        const float t = delay - (float) whole;
+
+        const SampleType xm1 = tap(whole - 1);
+        const SampleType x0 = tap(whole);
+        const SampleType x1 = tap(whole + 1);
+        const SampleType x2 = tap(whole + 2);
+
+        const float dm1 = t + 1.0f;
+        const float d1 = t - 1.0f;
+        const float d2 = t - 2.0f;
+
+        return xm1 * (-t * d1 * d2 / 6.0f)
+             + x0 * (dm1 * d1 * d2 * 0.5f)
+             + x1 * (-dm1 * t * d2 * 0.5f)
+             + x2 * (dm1 * t * d1 / 6.0f);
+    }
+};
+
+// First-order allpass. Flat magnitude response, which suits long static
+// echoes, but it transients when the delay is swept quickly.
+struct Thiran {
+    static constexpr float minimumDelay = 1.5f;
+
+    template <typename SampleType, typename Tap>
+    static SampleType read(Tap&& tap, float delay, SampleType& state){
+        // Keep the allpass fraction in [0.5, 1.5) where its group delay is best behaved
+        const int whole = (int) (delay - 0.5f);
+        const float fraction = delay - (float) whole;
+        const float coefficient = (1.0f - fraction) / (1.0f + fraction);
+
+        const SampleType x0 = tap(whole);
+        const SampleType x1 = tap(whole + 1);
+
+        state = (x0 - state) * coefficient + x1;
+        return state;
+    }
+};
+
+}
@@ -0,0 +1,171 @@
+/*
+  ==============================================================================
+
+    LFO.cpp
+    Created: 17 Oct 2026 11:02:15am
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#include "LFO.h"
+
+void LFO::prepare(double sampleRate, int maximumBlockSize, int numChannels){
+    lastSampleRate = sampleRate;
+    
+    quadratureBlock.setSize(2, maximumBlockSize);
+    offsetBlock.setSize(numChannels, maximumBlockSize);
+    channelBlocks.resize(numChannels);
+    
+    offsetSine.assign(numChannels, 0.0f);
+    offsetCosine.assign(numChannels, 1.0f);
+    phaseOffsetsActive = false;
+    updateChannelBlocks();
+    
+    setFrequency(frequency);
+    reset();
+}
+
+void LFO::reset(){
+    sine = 0.0f;
+    cosine = 1.0f;
+    quadratureBlock.clear();
+    offsetBlock.clear();
+}
+
+void LFO::setFrequency(const float newValue){
+    frequency = newValue;
+    
+    const double increment = juce::MathConstants<double>::twoPi * frequency / lastSampleRate;
+    incrementSine = (float) std::sin(increment);
+    incrementCosine = (float) std::cos(increment);
+    intervalSine = (float) std::sin(increment * updateInterval);
+    intervalCosine = (float) std::cos(increment * updateInterval);
+}
+
+void LFO::setUpdateInterval(const int numSamples){
+    
+    jassert(numSamples > 0);
+    
+    updateInterval = numSamples;
+    setFrequency(frequency);
+}
+
+void LFO::setPhase(const float sine, const float cosine){
+    this->sine = sine;
+    this->cosine = cosine;
+}
+
+void LFO::setPhaseOffset(const int channel, const float radians){
+    
+    jassert(juce::isPositiveAndBelow(channel, (int) offsetSine.size()));
+    
+    offsetSine[channel] = std::sin(radians);
+    offsetCosine[channel] = std::cos(radians);
+    
+    phaseOffsetsActive = false;
+    for (size_t i = 0; i < offsetSine.size(); ++i){
+        if (offsetSine[i] != 0.0f || offsetCosine[i] != 1.0f){
+            phaseOffsetsActive = true;
+        }
+    }
+    updateChannelBlocks();
+}
+
+void LFO::process(const int numSamples){
+    
+    jassert(numSamples <= quadratureBlock.getNumSamples());
+    
+    float* sineBlock = quadratureBlock.getWritePointer(0);
+    float* cosineBlock = quadratureBlock.getWritePointer(1);
+    
+    if (updateInterval > 1){
+        renderInterpolated(sineBlock, cosineBlock, numSamples);
+    }
+    else {
+        renderQuadrature(sineBlock, cosineBlock, numSamples);
+    }
+    normalise();
+    
+    if (!phaseOffsetsActive){
+        return;
+    }
+    
+    // sin(phase + offset) = sin(phase) cos(offset) + cos(phase) sin(offset)
+    for (int channel = 0; channel < offsetBlock.getNumChannels(); ++channel){
+        float* channelData = offsetBlock.getWritePointer(channel);
+        juce::FloatVectorOperations::copy(channelData, sineBlock, numSamples);
+        juce::FloatVectorOperations::multiply(channelData, offsetCosine[channel], numSamples);
+        juce::FloatVectorOperations::addWithMultiply(channelData, cosineBlock, offsetSine[channel], numSamples);
+    }
+}
+
+void LFO::skip(const int numSamples){
+    const double increment = juce::MathConstants<double>::twoPi * frequency / lastSampleRate * numSamples;
+    const float skipSine = (float) std::sin(increment);
+    const float skipCosine = (float) std::cos(increment);
+    
+    const float nextSine = sine * skipCosine + cosine * skipSine;
+    cosine = cosine * skipCosine - sine * skipSine;
+    sine = nextSine;
+    normalise();
+}
+
+void LFO::renderQuadrature(float* sineBlock, float* cosineBlock, const int numSamples){
+    
+    // Rotate the (sin, cos) pair by the phase increment each sample
+    float s = sine, c = cosine;
+    for (int sample = 0; sample < numSamples; ++sample){
+        sineBlock[sample] = s;
+        cosineBlock[sample] = c;
+        
+        const float nextSine = s * incrementCosine + c * incrementSine;
+        c = c * incrementCosine - s * incrementSine;
+        s = nextSine;
+    }
+    sine = s;
+    cosine = c;
+}
+
+void LFO::renderInterpolated(float* sineBlock, float* cosineBlock, const int numSamples){
+    
+    // Rotate once per interval and draw straight lines between the points
+    for (int start = 0; start < numSamples; start += updateInterval){
+        const int length = juce::jmin(updateInterval, numSamples - start);
+        
+        float stepSine = intervalSine, stepCosine = intervalCosine;
+        if (length < updateInterval){
+            // A block that isn't a whole number of intervals ends on a short one
+            const double increment = juce::MathConstants<double>::twoPi * frequency / lastSampleRate * length;
+            stepSine = (float) std::sin(increment);
+            stepCosine = (float) std::cos(increment);
+        }
+        
+        const float nextSine = sine * stepCosine + cosine * stepSine;
+        const float nextCosine = cosine * stepCosine - sine * stepSine;
+        const float sineSlope = (nextSine - sine) / (float) length;
+        const float cosineSlope = (nextCosine - cosine) / (float) length;
+        
+        for (int sample = 0; sample < length; ++sample){
+            sineBlock[start + sample] = sine + sineSlope * (float) sample;
+            cosineBlock[start + sample] = cosine + cosineSlope * (float) sample;
+        }
+        sine = nextSine;
+        cosine = nextCosine;
+    }
+}
+
+void LFO::updateChannelBlocks(){
+    for (int channel = 0; channel < (int) channelBlocks.size(); ++channel){
+        channelBlocks[channel] = phaseOffsetsActive ? offsetBlock.getReadPointer(channel)
+                                                    : quadratureBlock.getReadPointer(0);
+    }
+}
+
+void LFO::normalise(){
+    // The recursion slowly drifts off the unit circle; one Newton step per block pulls it back
+    const float magnitude = sine * sine + cosine * cosine;
+    const float correction = 1.5f - 0.5f * magnitude;
+    sine *= correction;
+    cosine *= correction;
+}
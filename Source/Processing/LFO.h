@@ -0,0 +1,72 @@
+/*
+  ==============================================================================
+
+    LFO.h
+    Created: 17 Oct 2026 11:02:15am
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+    Block-rate sine LFO for the delay modulation.
+
+    A single recursive quadrature oscillator renders sin/cos for the whole
+    block; each channel's output is then a phase-rotated mix of the two,
+    so per-channel phase offsets cost one multiply-add pass per channel and
+    nothing at all when every offset is zero.
+    
+    With an update interval above one the oscillator only steps once per
+    interval and the samples in between are linearly interpolated.
+*/
+class LFO {
+public:
+    void prepare(double sampleRate, int maximumBlockSize, int numChannels);
+    void reset();
+    
+    void setFrequency(const float frequency);
+    void setPhaseOffset(const int channel, const float radians);
+    void setUpdateInterval(const int numSamples);
+    
+    // Renders the next numSamples of every channel's LFO into the block buffers
+    void process(const int numSamples);
+    // Advances the phase without rendering anything
+    void skip(const int numSamples);
+    
+    // The current phase as its sin/cos pair, so a snapshot restores it bit for bit
+    float getPhaseSine() const { return sine; }
+    float getPhaseCosine() const { return cosine; }
+    void setPhase(const float sine, const float cosine);
+    
+    const float* getChannelBlock(const int channel) const { return channelBlocks[channel]; }
+    bool hasPhaseOffsets() const { return phaseOffsetsActive; }
+    
+private:
+    double lastSampleRate = 44100.0;
+    float frequency = 0.0f;
+    
+    // sin/cos of the current phase and of the per-sample phase increment
+    float sine = 0.0f, cosine = 1.0f;
+    float incrementSine = 0.0f, incrementCosine = 1.0f;
+    
+    // ...and of the increment over one update interval
+    int updateInterval = 1;
+    float intervalSine = 0.0f, intervalCosine = 1.0f;
+    
+    juce::AudioBuffer<float> quadratureBlock;  // channel 0 = sin, channel 1 = cos
+    juce::AudioBuffer<float> offsetBlock;      // per-channel output when offsets are active
+    std::vector<const float*> channelBlocks;
+    
+    std::vector<float> offsetSine, offsetCosine;
+    bool phaseOffsetsActive = false;
+    
+    void renderQuadrature(float* sineBlock, float* cosineBlock, const int numSamples);
+    void renderInterpolated(float* sineBlock, float* cosineBlock, const int numSamples);
+    void updateChannelBlocks();
+    void normalise();
+};
@@ -0,0 +1,167 @@
+/*
+  ==============================================================================
+
+    OutputStage.cpp
+    Created: 17 Oct 2026 9:48:30pm
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#include "OutputStage.h"
+
+namespace OutputCurves {
+
+// Each curve is odd, and flat at full scale past its knee. The passes below
+// clamp to the knee first as whole-block clips, so the curves themselves are
+// plain arithmetic on the clamped value c.
+
+// x - 4x^3 / 27, which meets full scale at 1.5 with zero slope
+struct PolynomialTanh {
+    static constexpr double knee = 1.5;
+    
+    template <typename SampleType>
+    static SampleType shape(SampleType c){
+        return c - c * c * c * (SampleType) (4.0 / 27.0);
+    }
+    
+    // Past the knee the curve is flat, so its integral grows with |x|
+    template <typename SampleType>
+    static SampleType antiderivative(SampleType x, SampleType c){
+        const SampleType c2 = c * c;
+        return c2 * (SampleType) 0.5 - c2 * c2 * (SampleType) (1.0 / 27.0) + std::abs(x) - std::abs(c);
+    }
+};
+
+// x (27 + x^2) / (27 + 9x^2), which reaches full scale at 3. Its integral
+// needs a log, so it costs more than the polynomial.
+struct RationalTanh {
+    static constexpr double knee = 3.0;
+    
+    template <typename SampleType>
+    static SampleType shape(SampleType c){
+        const SampleType c2 = c * c;
+        return c * (27 + c2) / (27 + 9 * c2);
+    }
+    
+    template <typename SampleType>
+    static SampleType antiderivative(SampleType x, SampleType c){
+        const SampleType c2 = c * c;
+        return c2 * (SampleType) (1.0 / 18.0) + (SampleType) (4.0 / 3.0) * std::log(1 + c2 * (SampleType) (1.0 / 3.0))
+               + std::abs(x) - std::abs(c);
+    }
+};
+
+}
+
+template <typename SampleType>
+void OutputStage<SampleType>::prepare(int numChannels, int maximumBlockSize){
+    lastInputs.assign((size_t) numChannels, 0);
+    savedLastInputs = lastInputs;
+    inputs.setSize(numChannels, maximumBlockSize + 1);
+    clampedInputs.setSize(numChannels, maximumBlockSize + 1);
+    antiderivatives.setSize(numChannels, maximumBlockSize + 1);
+}
+
+template <typename SampleType>
+void OutputStage<SampleType>::reset(){
+    std::fill(lastInputs.begin(), lastInputs.end(), (SampleType) 0);
+}
+
+template <typename SampleType>
+void OutputStage<SampleType>::saveStates(){
+    std::copy(lastInputs.begin(), lastInputs.end(), savedLastInputs.begin());
+}
+
+template <typename SampleType>
+void OutputStage<SampleType>::restoreStates(){
+    std::copy(savedLastInputs.begin(), savedLastInputs.end(), lastInputs.begin());
+}
+
+template <typename SampleType>
+void OutputStage<SampleType>::resetChannel(int channel){
+    lastInputs[(size_t) channel] = 0;
+}
+
+template <typename SampleType>
+bool OutputStage<SampleType>::process(SampleType* data, int numSamples, int channel){
+    
+    if (numSamples <= 0){
+        return true;
+    }
+    
+    if (!isFinite(data, numSamples)){
+        juce::FloatVectorOperations::clear(data, numSamples);
+        resetChannel(channel);
+        return false;
+    }
+    
+    switch (shape){
+        case OutputShape::polynomialTanh: processAntialiased<OutputCurves::PolynomialTanh>(data, numSamples, channel); break;
+        case OutputShape::rationalTanh:   processAntialiased<OutputCurves::RationalTanh>(data, numSamples, channel); break;
+        case OutputShape::clamp:
+        default:
+            lastInputs[(size_t) channel] = data[numSamples - 1];
+            juce::FloatVectorOperations::clip(data, data, (SampleType) -1, (SampleType) 1, numSamples);
+            break;
+    }
+    return true;
+}
+
+// An OR over compares rather than an early exit, so it vectorises. NaN
+// fails every compare, and infinity the one against the largest finite value.
+template <typename SampleType>
+bool OutputStage<SampleType>::isFinite(const SampleType* data, int numSamples){
+    int nonFinite = 0;
+    for (int sample = 0; sample < numSamples; ++sample){
+        nonFinite |= !(std::abs(data[sample]) <= std::numeric_limits<SampleType>::max());
+    }
+    return nonFinite == 0;
+}
+
+// Passes with no dependence between samples: the antiderivatives, then the
+// quotients. The weighted form below is
+//   w (F(x1) - F(x0)) / d + (1 - w) f((x0 + x1) / 2),  w = d^2 / (d^2 + blendWidth^2)
+// with no division by a step that might be zero. The difference of
+// antiderivatives loses precision to cancellation as the step shrinks, while
+// the midpoint drifts from the average as it grows; the blend width sits
+// where float's cancellation is still well below -100 dB, and is the same for
+// both precisions so they shape alike.
+template <typename SampleType>
+template <typename Curve>
+void OutputStage<SampleType>::processAntialiased(SampleType* data, int numSamples, int channel){
+    
+    SampleType* in = inputs.getWritePointer(channel);
+    SampleType* clamped = clampedInputs.getWritePointer(channel);
+    SampleType* integral = antiderivatives.getWritePointer(channel);
+    const SampleType knee = (SampleType) Curve::knee;
+    
+    // Both curves are flat long before the limit, so limiting the inputs
+    // barely moves the averages, and keeps the steps' squares finite
+    in[0] = lastInputs[(size_t) channel];
+    juce::FloatVectorOperations::clip(in + 1, data, (SampleType) -OUTPUT_STAGE_INPUT_LIMIT, (SampleType) OUTPUT_STAGE_INPUT_LIMIT, numSamples);
+    
+    // The curve may have changed since the last block, so the last input's
+    // antiderivative is taken afresh
+    juce::FloatVectorOperations::clip(clamped, in, -knee, knee, numSamples + 1);
+    for (int sample = 0; sample <= numSamples; ++sample){
+        integral[sample] = Curve::antiderivative(in[sample], clamped[sample]);
+    }
+    
+    for (int sample = 0; sample < numSamples; ++sample){
+        clamped[sample] = (in[sample + 1] + in[sample]) * (SampleType) 0.5;
+    }
+    juce::FloatVectorOperations::clip(clamped, clamped, -knee, knee, numSamples);
+    
+    const SampleType blendWidthSquared = (SampleType) (OUTPUT_STAGE_BLEND_WIDTH * OUTPUT_STAGE_BLEND_WIDTH);
+    for (int sample = 0; sample < numSamples; ++sample){
+        const SampleType step = in[sample + 1] - in[sample];
+        data[sample] = ((integral[sample + 1] - integral[sample]) * step + blendWidthSquared * Curve::shape(clamped[sample]))
+                       / (step * step + blendWidthSquared);
+    }
+    
+    lastInputs[(size_t) channel] = in[numSamples];
+}
+
+template class OutputStage<float>;
+template class OutputStage<double>;
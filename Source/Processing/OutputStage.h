@@ -0,0 +1,73 @@
+/*
+  ==============================================================================
+
+    OutputStage.h
+    Created: 17 Oct 2026 9:48:30pm
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#define OUTPUT_STAGE_INPUT_LIMIT 1.0e4  // far past the curves' knees, and small enough to square
+#define OUTPUT_STAGE_BLEND_WIDTH 0.03  // steps below this lean on the curve at their midpoint
+
+enum class OutputShape {
+    clamp,           // hard clip at full scale
+    polynomialTanh,  // cubic soft clip, anti-aliased
+    rationalTanh     // Pade tanh, anti-aliased
+};
+
+//==============================================================================
+/*
+    The last stage of every channel's output, keeping it within full scale.
+
+    Each channel's block is shaped in place as whole-block passes with no
+    branches per sample, so the loops vectorise. The clamp is a min/max; the
+    tanh curves use first-order antiderivative anti-aliasing, outputting
+    (F(x[n]) - F(x[n-1])) / (x[n] - x[n-1]), the curve's average between two
+    inputs rather than its value at one. A hot feedback loop driven into the
+    curve then aliases far less than it would through the curve itself. Where
+    two inputs are too close for that quotient to be accurate, it blends
+    smoothly into the curve at their midpoint instead.
+
+    The only state is each channel's last input, so the shape can change
+    between any two blocks without a glitch.
+
+    A block holding a NaN or an infinity is silenced rather than shaped, and
+    process() reports it so the caller can reset the channel it came from.
+*/
+template <typename SampleType>
+class OutputStage {
+public:
+    void prepare(int numChannels, int maximumBlockSize);
+    void reset();
+    
+    void setShape(OutputShape newShape) { shape = newShape; }
+    OutputShape getShape() const { return shape; }
+    
+    // For running a block through twice, as a crossfade does
+    void saveStates();
+    void restoreStates();
+    
+    // Shapes one channel's block in place. Returns false, leaving the block
+    // silent, if it wasn't all finite.
+    bool process(SampleType* data, int numSamples, int channel);
+    void resetChannel(int channel);
+private:
+    OutputShape shape = OutputShape::clamp;
+    
+    std::vector<SampleType> lastInputs, savedLastInputs;  // per channel
+    
+    // Per channel, so groups can shape their channels side by side: the
+    // block's inputs, clamped to the curve's knee, and their antiderivatives,
+    // each preceded by the last block's final input
+    juce::AudioBuffer<SampleType> inputs, clampedInputs, antiderivatives;
+    
+    static bool isFinite(const SampleType* data, int numSamples);
+    
+    template <typename Curve>
+    void processAntialiased(SampleType* data, int numSamples, int channel);
+};
@@ -0,0 +1,103 @@
+/*
+  ==============================================================================
+
+    ParameterRamp.h
+    Created: 17 Oct 2026 12:20:41pm
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+    Control-rate view of a SmoothedValue for one block.
+
+    render() is called once at the start of a block: a moving smoother is
+    stepped into a contiguous buffer, a settled one is just flagged constant
+    and costs nothing further. The kernels then read plain values or run
+    whole-block vector operations instead of stepping smoothers per sample.
+    
+    A step above one renders a staircase instead, holding each value for
+    step samples, which is cheaper but coarser.
+    
+    SampleType is the type the ramp is applied to, so gains on a double
+    signal are rendered in double.
+*/
+template <typename SampleType>
+class ParameterRamp {
+public:
+    void prepare(int maximumBlockSize){
+        ramp.setSize(1, maximumBlockSize);
+        constant = true;
+    }
+    
+    template <typename SmoothedValueType>
+    void render(SmoothedValueType& smoothedValue, int numSamples, int step = 1){
+        
+        jassert(numSamples <= ramp.getNumSamples());
+        
+        constant = !smoothedValue.isSmoothing();
+        if (constant){
+            value = smoothedValue.getTargetValue();
+            return;
+        }
+        
+        SampleType* rampData = ramp.getWritePointer(0);
+        if (step > 1){
+            for (int start = 0; start < numSamples; start += step){
+                const int length = juce::jmin(step, numSamples - start);
+                juce::FloatVectorOperations::fill(rampData + start, smoothedValue.skip(length), length);
+            }
+        }
+        else {
+            for (int sample = 0; sample < numSamples; ++sample){
+                rampData[sample] = smoothedValue.getNextValue();
+            }
+        }
+        value = rampData[numSamples - 1];
+    }
+    
+    bool isConstant() const { return constant; }
+    SampleType getConstant() const { return value; }
+    const SampleType* getBlock() const { return ramp.getReadPointer(0); }
+    
+    SampleType operator[](int sample) const { return constant ? value : ramp.getReadPointer(0)[sample]; }
+    
+    // Largest magnitude over the first numSamples
+    SampleType getPeak(int numSamples) const {
+        if (constant){
+            return std::abs(value);
+        }
+        const auto range = juce::FloatVectorOperations::findMinAndMax(getBlock(), numSamples);
+        return juce::jmax(-range.getStart(), range.getEnd());
+    }
+    
+    // dest *= ramp
+    void multiply(SampleType* dest, int numSamples) const {
+        if (constant){
+            juce::FloatVectorOperations::multiply(dest, value, numSamples);
+        }
+        else {
+            juce::FloatVectorOperations::multiply(dest, getBlock(), numSamples);
+        }
+    }
+    
+    // dest += source * ramp
+    void addWithMultiply(SampleType* dest, const SampleType* source, int numSamples) const {
+        if (constant){
+            juce::FloatVectorOperations::addWithMultiply(dest, source, value, numSamples);
+        }
+        else {
+            juce::FloatVectorOperations::addWithMultiply(dest, source, getBlock(), numSamples);
+        }
+    }
+    
+private:
+    juce::AudioBuffer<SampleType> ramp;
+    SampleType value = 0;
+    bool constant = true;
+};
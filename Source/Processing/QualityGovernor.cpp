@@ -0,0 +1,104 @@
+/*
+  ==============================================================================
+
+    QualityGovernor.cpp
+    Created: 17 Oct 2026 6:12:27pm
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#include "QualityGovernor.h"
+
+void QualityGovernor::prepare(double sampleRate){
+    lastSampleRate = sampleRate;
+    reset();
+}
+
+void QualityGovernor::reset(){
+    quality = DelayQuality::medium;
+    overBudgetCount = 0;
+    headroomSamples = 0;
+    
+    recoveryLength = (int) (lastSampleRate * RECOVERY_SECONDS);
+    hasSteppedUp = false;
+    heldSamples = 0;
+}
+
+void QualityGovernor::setBudget(const float fraction){
+    
+    jassert(fraction > 0.0f && fraction <= 1.0f);
+    
+    this->budget = fraction;
+}
+
+void QualityGovernor::addMeasurement(const double seconds, const int numSamples){
+    
+    if (numSamples <= 0){
+        return;
+    }
+    
+    const double load = seconds * lastSampleRate / numSamples;
+    
+    // Held as long as it took to earn, the tier has proved itself
+    if (hasSteppedUp){
+        heldSamples += numSamples;
+        if (heldSamples >= recoveryLength){
+            hasSteppedUp = false;
+            recoveryLength = (int) (lastSampleRate * RECOVERY_SECONDS);
+        }
+    }
+    
+    if (load > budget){
+        headroomSamples = 0;
+        if (++overBudgetCount >= OVER_BUDGET_BLOCKS){
+            stepDown();
+        }
+        return;
+    }
+    
+    overBudgetCount = juce::jmax(0, overBudgetCount - 1);
+    
+    if (load < budget * HEADROOM_FRACTION){
+        headroomSamples += numSamples;
+        if (headroomSamples >= recoveryLength){
+            stepUp();
+        }
+    }
+    else {
+        headroomSamples = 0;
+    }
+}
+
+void QualityGovernor::stepDown(){
+    if (hasSteppedUp){
+        recoveryLength = juce::jmin(2 * recoveryLength, (int) (lastSampleRate * MAX_RECOVERY_SECONDS));
+        hasSteppedUp = false;
+    }
+    
+    if (quality == DelayQuality::high){
+        quality = DelayQuality::medium;
+    }
+    else if (quality == DelayQuality::medium){
+        quality = DelayQuality::low;
+    }
+    overBudgetCount = 0;
+    headroomSamples = 0;
+}
+
+void QualityGovernor::stepUp(){
+    const DelayQuality previous = quality;
+    if (quality == DelayQuality::low){
+        quality = DelayQuality::medium;
+    }
+    else if (quality == DelayQuality::medium){
+        quality = DelayQuality::high;
+    }
+    overBudgetCount = 0;
+    headroomSamples = 0;
+    
+    if (quality != previous){
+        hasSteppedUp = true;
+        heldSamples = 0;
+    }
+}
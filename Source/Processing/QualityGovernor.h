@@ -0,0 +1,63 @@
+/*
+  ==============================================================================
+
+    QualityGovernor.h
+    Created: 17 Oct 2026 6:12:27pm
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Delay.h"
+#define DEFAULT_CPU_BUDGET 0.1f  // the host shares each block's real time with every other plugin
+#define OVER_BUDGET_BLOCKS 2
+#define HEADROOM_FRACTION 0.3f  // the next tier up can cost a few times the current one
+#define RECOVERY_SECONDS 2.0
+#define MAX_RECOVERY_SECONDS 30.0
+
+//==============================================================================
+/*
+    Picks a DelayQuality tier from how long each block took to process.
+
+    Load is the processing time as a fraction of the block's real time,
+    and the budget is this instance's share of it. It starts at medium,
+    which keeps the prepared interpolator at a coarser control rate. A
+    block over the budget counts towards stepping down and a block under
+    it counts back off, so the tier drops after about OVER_BUDGET_BLOCKS
+    overloaded blocks. Stepping up takes RECOVERY_SECONDS
+    of unbroken headroom, with load below HEADROOM_FRACTION of the budget.
+    A step up that drops back before it has held that long doubles the
+    wait for the next one, up to MAX_RECOVERY_SECONDS, so a tier that
+    doesn't fit isn't retried every few seconds.
+*/
+class QualityGovernor {
+public:
+    void prepare(double sampleRate);
+    void reset();
+    
+    // Fraction of the real-time budget a block may use, 0 to 1
+    void setBudget(const float fraction);
+    
+    // Reports that numSamples took seconds to process
+    void addMeasurement(const double seconds, const int numSamples);
+    
+    DelayQuality getQuality() const { return quality; }
+
+private:
+    double lastSampleRate = 44100.0;
+    float budget = DEFAULT_CPU_BUDGET;
+    
+    DelayQuality quality = DelayQuality::medium;
+    int overBudgetCount = 0;
+    int headroomSamples = 0;
+    
+    int recoveryLength = 0;  // samples of headroom a step up takes
+    bool hasSteppedUp = false;  // and the tier stepped up to hasn't held that long yet
+    int heldSamples = 0;
+    
+    void stepDown();
+    void stepUp();
+};
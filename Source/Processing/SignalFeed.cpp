@@ -0,0 +1,121 @@
+/*
+  ==============================================================================
+
+    SignalFeed.cpp
+    Created: 17 Oct 2026 8:17:52pm
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#include "SignalFeed.h"
+
+SignalFeed::SignalFeed(){
+    summaries.resize(SIGNAL_FEED_CAPACITY);
+    pendingInputs.resize(2);
+}
+
+void SignalFeed::prepare(double sampleRate, int maximumBlockSize){
+    samplesPerSummary = juce::jmax(1, juce::roundToInt(sampleRate / SUMMARIES_PER_SECOND));
+    position = 0;
+    
+    // A block can finish every summary it spans, plus the one it started in
+    pendingInputs.assign((size_t) (maximumBlockSize / samplesPerSummary + 2), LevelSummary());
+    currentOutput = LevelSummary();
+    
+    summaryRate.store(sampleRate / samplesPerSummary, std::memory_order_relaxed);
+    generation.fetch_add(1, std::memory_order_release);
+}
+
+template <typename SampleType>
+void SignalFeed::addInput(const juce::AudioBuffer<SampleType>& buffer, int numChannels){
+    const int numSamples = buffer.getNumSamples();
+    const int lastPending = (int) pendingInputs.size() - 1;
+    
+    // Walks the block a summary at a time, in the same steps addOutput() takes.
+    // A host block beyond the prepared size piles into the last summary.
+    int summary = 0;
+    for (int start = 0, fill = position; start < numSamples;){
+        const int length = juce::jmin(numSamples - start, samplesPerSummary - fill);
+        pendingInputs[(size_t) summary].merge(summarise(buffer, numChannels, start, length));
+        
+        start += length;
+        fill += length;
+        if (fill == samplesPerSummary){
+            fill = 0;
+            if (summary < lastPending){
+                pendingInputs[(size_t) ++summary] = LevelSummary();
+            }
+        }
+    }
+}
+
+template <typename SampleType>
+void SignalFeed::addOutput(const juce::AudioBuffer<SampleType>& buffer, int numChannels){
+    const int numSamples = buffer.getNumSamples();
+    const int lastPending = (int) pendingInputs.size() - 1;
+    
+    int summary = 0;
+    for (int start = 0; start < numSamples;){
+        const int length = juce::jmin(numSamples - start, samplesPerSummary - position);
+        currentOutput.merge(summarise(buffer, numChannels, start, length));
+        
+        start += length;
+        position += length;
+        if (position == samplesPerSummary){
+            position = 0;
+            if (summary < lastPending){
+                push({ pendingInputs[(size_t) summary], currentOutput });
+                currentOutput = LevelSummary();
+                ++summary;
+            }
+        }
+    }
+    
+    // The unfinished summary carries over to the next block
+    pendingInputs[0] = pendingInputs[(size_t) summary];
+}
+
+template <typename SampleType>
+LevelSummary SignalFeed::summarise(const juce::AudioBuffer<SampleType>& buffer, int numChannels, int start, int numSamples){
+    LevelSummary summary;
+    if (numSamples <= 0){
+        return summary;
+    }
+    
+    for (int channel = 0; channel < numChannels; ++channel){
+        const SampleType* samples = buffer.getReadPointer(channel, start);
+        const auto range = juce::FloatVectorOperations::findMinAndMax(samples, numSamples);
+        
+        SampleType sumOfSquares = 0;
+        for (int i = 0; i < numSamples; ++i){
+            sumOfSquares += samples[i] * samples[i];
+        }
+        
+        summary.merge({ (float) range.getStart(), (float) range.getEnd(), (float) sumOfSquares, numSamples });
+    }
+    return summary;
+}
+
+void SignalFeed::push(const SignalSummary& summary){
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(1, start1, size1, start2, size2);
+    if (size1 > 0){
+        summaries[(size_t) start1] = summary;
+    }
+    fifo.finishedWrite(size1);
+}
+
+int SignalFeed::read(SignalSummary* destination, int maxSummaries){
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(maxSummaries, start1, size1, start2, size2);
+    std::copy_n(summaries.begin() + start1, size1, destination);
+    std::copy_n(summaries.begin() + start2, size2, destination + size1);
+    fifo.finishedRead(size1 + size2);
+    return size1 + size2;
+}
+
+template void SignalFeed::addInput<float>(const juce::AudioBuffer<float>&, int);
+template void SignalFeed::addInput<double>(const juce::AudioBuffer<double>&, int);
+template void SignalFeed::addOutput<float>(const juce::AudioBuffer<float>&, int);
+template void SignalFeed::addOutput<double>(const juce::AudioBuffer<double>&, int);
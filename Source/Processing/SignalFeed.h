@@ -0,0 +1,108 @@
+/*
+  ==============================================================================
+
+    SignalFeed.h
+    Created: 17 Oct 2026 8:17:52pm
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#define SUMMARIES_PER_SECOND 500
+#define SIGNAL_FEED_CAPACITY 4096
+
+// Peak and power of a stretch of samples, across every channel
+struct LevelSummary {
+    float minimum = 0.0f;
+    float maximum = 0.0f;
+    float sumOfSquares = 0.0f;
+    int numSamples = 0;
+    
+    void merge(const LevelSummary& other){
+        if (other.numSamples == 0){
+            return;
+        }
+        minimum = numSamples == 0 ? other.minimum : juce::jmin(minimum, other.minimum);
+        maximum = numSamples == 0 ? other.maximum : juce::jmax(maximum, other.maximum);
+        sumOfSquares += other.sumOfSquares;
+        numSamples += other.numSamples;
+    }
+    
+    float getPeak() const { return juce::jmax(-minimum, maximum); }
+    float getRms() const { return numSamples > 0 ? std::sqrt(sumOfSquares / (float) numSamples) : 0.0f; }
+};
+
+// The input and output over the same stretch of time
+struct SignalSummary {
+    LevelSummary input;
+    LevelSummary output;
+    
+    void merge(const SignalSummary& other){
+        input.merge(other.input);
+        output.merge(other.output);
+    }
+};
+
+//==============================================================================
+/*
+    Carries decimated summaries of the plugin's input and output from the
+    audio thread to the editor, for meters and the echo view.
+
+    The audio thread summarises each block as it passes, SUMMARIES_PER_SECOND
+    times a second, and pushes the summaries into a juce::AbstractFifo. That
+    costs one pass over the block either side of the delay, never a look at
+    the delay memory, and nothing at all unless a view has enabled the feed.
+    Pushing is wait-free; when the reader falls behind, the newest
+    summaries are dropped rather than waiting for room.
+
+    Single reader on the message thread, single writer on the audio thread.
+*/
+class SignalFeed {
+public:
+    SignalFeed();
+    
+    // Not concurrent with the audio thread's calls
+    void prepare(double sampleRate, int maximumBlockSize);
+    
+    // The feed only summarises while a view is open
+    void setEnabled(bool shouldBeEnabled) { enabled.store(shouldBeEnabled, std::memory_order_relaxed); }
+    bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+    
+    // Audio thread: the block before the delay processes it in place, then after
+    template <typename SampleType>
+    void addInput(const juce::AudioBuffer<SampleType>& buffer, int numChannels);
+    template <typename SampleType>
+    void addOutput(const juce::AudioBuffer<SampleType>& buffer, int numChannels);
+    
+    // Reader: copies out up to maxSummaries, oldest first, and returns how many
+    int read(SignalSummary* destination, int maxSummaries);
+    
+    // Summaries per second, and a count that changes whenever that may have,
+    // so the reader knows to start its history over
+    double getSummaryRate() const { return summaryRate.load(std::memory_order_relaxed); }
+    int getGeneration() const { return generation.load(std::memory_order_acquire); }
+    
+private:
+    juce::AbstractFifo fifo { SIGNAL_FEED_CAPACITY };
+    std::vector<SignalSummary> summaries;
+    
+    std::atomic<bool> enabled { false };
+    std::atomic<double> summaryRate { SUMMARIES_PER_SECOND };
+    std::atomic<int> generation { 0 };
+    
+    int samplesPerSummary = 1;
+    int position = 0;  // samples into the current summary
+    
+    // The input pass's summaries, waiting for their output halves. The first
+    // carries on from the last block, the last into the next one.
+    std::vector<LevelSummary> pendingInputs;
+    LevelSummary currentOutput;
+    
+    template <typename SampleType>
+    static LevelSummary summarise(const juce::AudioBuffer<SampleType>& buffer, int numChannels, int start, int numSamples);
+    
+    void push(const SignalSummary& summary);
+};
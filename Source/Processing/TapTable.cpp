@@ -0,0 +1,116 @@
+/*
+  ==============================================================================
+
+    TapTable.cpp
+    Created: 17 Oct 2026 4:08:37pm
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#include "TapTable.h"
+
+template <typename SampleType>
+void TapTable<SampleType>::prepare(double sampleRate, int numChannels){
+    this->numChannels = numChannels;
+    rampLength = juce::jmax(1, (int) (sampleRate * 0.02));
+    
+    delay.resize(MAX_TAPS);
+    feedbackSend.resize(MAX_TAPS);
+    channelGains.resize((size_t) numChannels);
+    for (auto& gains : channelGains){
+        gains.resize(MAX_TAPS);
+    }
+    
+    interpolatorStates.assign((size_t) numChannels, std::vector<SampleType>(MAX_TAPS, 0));
+    
+    reset();
+}
+
+template <typename SampleType>
+void TapTable<SampleType>::reset(){
+    delay.snap();
+    feedbackSend.snap();
+    for (auto& gains : channelGains){
+        gains.snap();
+    }
+    
+    
+    // Taps start at their first setting after a reset rather than gliding to it
+    delay.unset();
+    feedbackSend.unset();
+    for (auto& gains : channelGains){
+        gains.unset();
+    }
+    for (auto& states : interpolatorStates){
+        std::fill(states.begin(), states.end(), (SampleType) 0);
+    }
+}
+
+template <typename SampleType>
+void TapTable<SampleType>::setNumTaps(const int numTaps){
+    jassert(numTaps >= 0 && numTaps <= MAX_TAPS);
+    
+    const int newNumTaps = juce::jlimit(0, MAX_TAPS, numTaps);
+    
+    // Newly enabled taps start at their first setting rather than gliding to it
+    for (int tap = this->numTaps; tap < newNumTaps; ++tap){
+        delay.unset(tap);
+        feedbackSend.unset(tap);
+        for (auto& gains : channelGains){
+            gains.unset(tap);
+        }
+    }
+    this->numTaps = newNumTaps;
+}
+
+template <typename SampleType>
+void TapTable<SampleType>::setTap(const int tap, const float delay_samples, const float gain, const float pan, const float feedbackSend){
+    jassert(tap >= 0 && tap < MAX_TAPS);
+    
+    const float angle = (juce::jlimit(-1.0f, 1.0f, pan) + 1.0f) * juce::MathConstants<float>::pi * 0.25f;
+    auto getChannelGain = [&](int channel){
+        if (numChannels != 2){
+            return gain;
+        }
+        return gain * (channel == 0 ? std::cos(angle) : std::sin(angle));
+    };
+    
+    // Only restart the glide when something moved, so hosts that resend
+    // every parameter each block don't keep it from ever arriving
+    bool changed = delay.getTarget(tap) != delay_samples || this->feedbackSend.getTarget(tap) != feedbackSend;
+    for (int channel = 0; channel < numChannels; ++channel){
+        changed = changed || channelGains[channel].getTarget(tap) != getChannelGain(channel);
+    }
+    
+    if (!changed && delay.isSet(tap)){
+        return;
+    }
+    
+    delay.setTarget(tap, delay_samples, rampLength);
+    this->feedbackSend.setTarget(tap, feedbackSend, rampLength);
+    for (int channel = 0; channel < numChannels; ++channel){
+        channelGains[channel].setTarget(tap, getChannelGain(channel), rampLength);
+    }
+}
+
+template <typename SampleType>
+void TapTable<SampleType>::advance(const int numSamples){
+    delay.advance(numTaps, numSamples);
+    feedbackSend.advance(numTaps, numSamples);
+    for (auto& gains : channelGains){
+        gains.advance(numTaps, numSamples);
+    }
+}
+
+template <typename SampleType>
+float TapTable<SampleType>::getLongestDelay() const {
+    float longest = 0.0f;
+    for (int tap = 0; tap < numTaps; ++tap){
+        longest = juce::jmax(longest, delay.getCurrent(tap), delay.getTarget(tap));
+    }
+    return longest;
+}
+
+template class TapTable<float>;
+template class TapTable<double>;
@@ -0,0 +1,69 @@
+/*
+  ==============================================================================
+
+    TapTable.h
+    Created: 17 Oct 2026 4:08:37pm
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "GlideArray.h"
+#define MAX_TAPS 8
+
+//==============================================================================
+/*
+    Read taps for the delay's multi-tap mode.
+
+    Every tap reads the one delay memory the write head already fills, so
+    adding taps costs reads but no memory or write traffic. Parameters are
+    stored structure-of-arrays, one array per field indexed by tap, so the
+    kernels sweep each field across all taps with contiguous loads.
+
+    Changes glide over 20 ms like the delay's other smoothers. advance()
+    moves the glides on by one block; within that block a field's value at
+    sample s is its start plus s times its increment.
+    
+    The taps' times and gains are control values and always float; only
+    the interpolators' state follows the delay's SampleType.
+*/
+template <typename SampleType>
+class TapTable {
+public:
+    void prepare(double sampleRate, int numChannels);
+    void reset();
+    
+    void setNumTaps(const int numTaps);
+    int getNumTaps() const { return numTaps; }
+    
+    // pan runs from -1 (left) to 1 (right) with an equal-power law; it only
+    // applies to stereo, other layouts get the tap's gain on every channel
+    void setTap(const int tap, const float delay_samples, const float gain, const float pan, const float feedbackSend);
+    
+    void advance(const int numSamples);
+    
+    // The furthest back any tap reads until its glide is done
+    float getLongestDelay() const;
+    
+    const float* getDelayStart() const { return delay.getStart(); }
+    const float* getDelayIncrement() const { return delay.getIncrement(); }
+    const float* getGainStart(const int channel) const { return channelGains[channel].getStart(); }
+    const float* getGainIncrement(const int channel) const { return channelGains[channel].getIncrement(); }
+    const float* getSendStart() const { return feedbackSend.getStart(); }
+    const float* getSendIncrement() const { return feedbackSend.getIncrement(); }
+    
+    // Fractional-delay state for recursive interpolators, one per tap
+    SampleType* getInterpolatorStates(const int channel) { return interpolatorStates[channel].data(); }
+
+private:
+    int numTaps = 0;
+    int numChannels = 0;
+    int rampLength = 0;
+    
+    GlideArray delay, feedbackSend;
+    std::vector<GlideArray> channelGains;
+    std::vector<std::vector<SampleType>> interpolatorStates;
+};
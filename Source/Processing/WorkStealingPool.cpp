@@ -0,0 +1,199 @@
+/*
+  ==============================================================================
+
+    WorkStealingPool.cpp
+    Created: 17 Oct 2026 5:31:09pm
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#include "WorkStealingPool.h"
+
+#if JUCE_MAC || JUCE_IOS
+ #include <dispatch/dispatch.h>
+#elif JUCE_WINDOWS
+ #include <windows.h>
+#else
+ #include <semaphore.h>
+ #include <cerrno>
+#endif
+
+// Spins before the caller starts yielding while workers finish their last tasks
+#define COMPLETION_SPINS 4096
+
+WorkStealingPool::WorkStealingPool(int numWorkers){
+    numParticipants = juce::jmax(0, numWorkers) + 1;
+    ranges.reset(new Range[(size_t) numParticipants]);
+    
+    for (int participant = 1; participant < numParticipants; ++participant){
+        workers.push_back(std::make_unique<Worker>(*this, participant));
+        
+        // Workers stand in for the audio thread, so they're scheduled like it
+        // where the system allows
+        if (!workers.back()->startRealtimeThread(juce::Thread::RealtimeOptions().withPriority(10))){
+            workers.back()->startThread(juce::Thread::Priority::highest);
+        }
+    }
+}
+
+WorkStealingPool::~WorkStealingPool(){
+    for (auto& worker : workers){
+        worker->signalThreadShouldExit();
+        worker->wakeSignal.signal();
+    }
+    for (auto& worker : workers){
+        worker->stopThread(1000);
+    }
+}
+
+void WorkStealingPool::run(int numTasks, const std::function<void(int)>& task){
+    
+    if (numTasks <= 0){
+        return;
+    }
+    
+    if (workers.empty()){
+        for (int index = 0; index < numTasks; ++index){
+            task(index);
+        }
+        return;
+    }
+    
+    // Every task of the last batch has completed, so nothing counts against
+    // the new one. Each range is retagged before its end moves, so a late
+    // claimant from the last batch fails on the tag rather than reading a
+    // half-written range.
+    const juce::uint32 batch = generation.load() + 1;
+    currentTask = &task;
+    numCompleted.store(0);
+    for (int participant = 0; participant < numParticipants; ++participant){
+        const auto start = (juce::uint64) (participant * numTasks / numParticipants);
+        ranges[participant].next.store(((juce::uint64) batch << 32) | start);
+        ranges[participant].end.store((participant + 1) * numTasks / numParticipants);
+    }
+    generation.store(batch);
+    
+    for (auto& worker : workers){
+        worker->wakeSignal.signal();
+    }
+    
+    // Runs everything the workers haven't claimed yet, so only tasks already
+    // under way are waited on
+    work(0, batch);
+    
+    for (int spins = 0; numCompleted.load() < numTasks; ++spins){
+        if (spins >= COMPLETION_SPINS){
+            std::this_thread::yield();
+        }
+    }
+}
+
+void WorkStealingPool::work(int participant, juce::uint32 batch){
+    // Own range first, then the others' in turn
+    for (int offset = 0; offset < numParticipants; ++offset){
+        const int range = (participant + offset) % numParticipants;
+        while (runOne(range, batch)){}
+    }
+}
+
+bool WorkStealingPool::runOne(int range, juce::uint32 batch){
+    auto claim = ranges[range].next.load();
+    
+    while (true){
+        if ((juce::uint32) (claim >> 32) != batch){
+            return false;
+        }
+        if ((int) (juce::uint32) claim >= ranges[range].end.load()){
+            return false;
+        }
+        // Fails if the range was claimed from or retagged since it was read
+        if (ranges[range].next.compare_exchange_weak(claim, claim + 1)){
+            break;
+        }
+    }
+    
+    (*currentTask)((int) (juce::uint32) claim);
+    numCompleted.fetch_add(1);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// WakeSignal
+//-----------------------------------------------------------------------------
+#if JUCE_MAC || JUCE_IOS
+
+WorkStealingPool::WakeSignal::WakeSignal(){
+    handle = dispatch_semaphore_create(0);
+}
+
+WorkStealingPool::WakeSignal::~WakeSignal(){
+    dispatch_release((dispatch_semaphore_t) handle);
+}
+
+void WorkStealingPool::WakeSignal::signal(){
+    dispatch_semaphore_signal((dispatch_semaphore_t) handle);
+}
+
+void WorkStealingPool::WakeSignal::wait(){
+    dispatch_semaphore_wait((dispatch_semaphore_t) handle, DISPATCH_TIME_FOREVER);
+}
+
+#elif JUCE_WINDOWS
+
+WorkStealingPool::WakeSignal::WakeSignal(){
+    handle = CreateSemaphoreW(nullptr, 0, LONG_MAX, nullptr);
+}
+
+WorkStealingPool::WakeSignal::~WakeSignal(){
+    CloseHandle((HANDLE) handle);
+}
+
+void WorkStealingPool::WakeSignal::signal(){
+    ReleaseSemaphore((HANDLE) handle, 1, nullptr);
+}
+
+void WorkStealingPool::WakeSignal::wait(){
+    WaitForSingleObject((HANDLE) handle, INFINITE);
+}
+
+#else
+
+WorkStealingPool::WakeSignal::WakeSignal(){
+    auto* semaphore = new sem_t;
+    sem_init(semaphore, 0, 0);
+    handle = semaphore;
+}
+
+WorkStealingPool::WakeSignal::~WakeSignal(){
+    auto* semaphore = (sem_t*) handle;
+    sem_destroy(semaphore);
+    delete semaphore;
+}
+
+void WorkStealingPool::WakeSignal::signal(){
+    sem_post((sem_t*) handle);
+}
+
+void WorkStealingPool::WakeSignal::wait(){
+    while (sem_wait((sem_t*) handle) != 0 && errno == EINTR){}
+}
+
+#endif
+
+//-----------------------------------------------------------------------------
+// Worker
+//-----------------------------------------------------------------------------
+WorkStealingPool::Worker::Worker(WorkStealingPool& owner, int participant)
+    : juce::Thread("Delay Worker"), owner(owner), participant(participant){
+}
+
+void WorkStealingPool::Worker::run(){
+    while (!threadShouldExit()){
+        wakeSignal.wait();
+        
+        // Only claims tagged with this generation succeed, so a wake meant
+        // for an earlier batch finds nothing and goes back to sleep
+        owner.work(participant, owner.generation.load());
+    }
+}
@@ -0,0 +1,90 @@
+/*
+  ==============================================================================
+
+    WorkStealingPool.h
+    Created: 17 Oct 2026 5:31:09pm
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+    Fixed set of worker threads that run one batch of indexed tasks at a time.
+
+    run() splits the task indices into one contiguous range per participant,
+    the calling thread included, and wakes the workers. Each participant
+    works through its own range and then steals from the others' ranges,
+    so a slow batch on one core doesn't leave the rest idle. Nothing is
+    allocated or locked, so run() can be called from the audio thread. It
+    returns once every task has finished.
+
+    Every claim carries the batch's generation next to the index, and a
+    claim only succeeds if it matches the generation the claimant started
+    on. A worker that wakes late for an old batch therefore can't take
+    indices from the new one, however far run() has got in setting it up.
+    The workers run at realtime priority and sleep on a semaphore, which
+    run() posts without taking a lock. The caller never waits for a worker
+    to wake: whatever hasn't been claimed by the time its own range is done,
+    it runs itself.
+*/
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(int numWorkers);
+    ~WorkStealingPool();
+    
+    int getNumWorkers() const { return (int) workers.size(); }
+    
+    // task is only read during the call, so it can be built once and reused
+    void run(int numTasks, const std::function<void(int)>& task);
+
+private:
+    // Counting semaphore a worker sleeps on. Posting it takes no lock.
+    class WakeSignal {
+    public:
+        WakeSignal();
+        ~WakeSignal();
+        
+        void signal();
+        void wait();
+        
+    private:
+        void* handle = nullptr;
+        
+        JUCE_DECLARE_NON_COPYABLE(WakeSignal)
+    };
+    
+    class Worker : public juce::Thread {
+    public:
+        Worker(WorkStealingPool& owner, int participant);
+        void run() override;
+        
+        WakeSignal wakeSignal;
+    
+    private:
+        WorkStealingPool& owner;
+        const int participant;
+    };
+    
+    // next holds the generation in its high half and the next index in its
+    // low half. Padded so participants claiming tasks don't share a cache line.
+    struct alignas(64) Range {
+        std::atomic<juce::uint64> next { 0 };
+        std::atomic<int> end { 0 };
+    };
+    
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::unique_ptr<Range[]> ranges;
+    int numParticipants = 1;
+    
+    const std::function<void(int)>* currentTask = nullptr;
+    std::atomic<juce::uint32> generation { 0 };
+    std::atomic<int> numCompleted { 0 };
+    
+    void work(int participant, juce::uint32 batch);
+    bool runOne(int range, juce::uint32 batch);
+};
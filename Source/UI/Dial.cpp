@@ -1,67 +1,127 @@
-/*
-  ==============================================================================
-
-    Dial.cpp
-    Created: 26 Aug 2025 11:33:23am
-    Author:  Chris
-
-  ==============================================================================
-*/
-
-#include <JuceHeader.h>
-#include "Dial.h"
-
-//==============================================================================
-Dial::Dial(juce::AudioProcessorValueTreeState& treeState, juce::String parameterId, juce::String parameterName)
-{
-    initLabel(parameterName);
-    addAndMakeVisible(label);
-    
-    initSlider(treeState, parameterId);
-    slider.setLookAndFeel(&dialStyle);
-    addAndMakeVisible(slider);
-}
-
-Dial::~Dial()
-{
-}
-
-void Dial::initSlider(juce::AudioProcessorValueTreeState& treeState, juce::String parameterId){
-    slider.setSliderStyle(juce::Slider::SliderStyle::Rotary);
-    slider.setTextBoxStyle(juce::Slider::NoTextBox, true, 0, 0);
-    
-    sliderAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(treeState, parameterId, slider);
-}
-
-void Dial::initLabel(const juce::String parameterName){
-    label.setColour(juce::Label::ColourIds::textColourId, juce::Colours::white);
-    label.setJustificationType(juce::Justification::centred);
-    label.setFont(juce::FontOptions(12.0f));
-    label.setText(parameterName, juce::dontSendNotification);
-}
-
-void Dial::paint (juce::Graphics& g)
-{
-}
-
-void Dial::resized()
-{
-    int labelWidth = getWidth() / 2;
-    int labelHeight = getHeight() * 0.25;
-    int labelX = getWidth() / 2 - labelWidth / 2;
-    int labelY = 0;
-    label.setBounds(labelX, labelY, labelWidth, labelHeight);
-    
-    int sliderWidth, sliderHeight;
-    sliderWidth = sliderHeight = getHeight() * 0.65 * 1.25;
-    int sliderX = getWidth() / 2 - sliderWidth / 2;
-    int sliderY = label.getBottom();
-    
-    slider.setBounds(sliderX, sliderY, sliderWidth, sliderHeight);
-}
-
-bool Dial::hitTest(int x, int y) {
-    bool withinSliderHorizontal = slider.getX() <= x && x <= slider.getRight();
-    bool withinSliderVertical = slider.getY() <= y && y <= slider.getBottom();
-    return withinSliderHorizontal && withinSliderVertical;
-}
+/*
+  ==============================================================================
+
+    Dial.cpp
+    Created: 26 Aug 2025 11:33:23am
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "Dial.h"
+
+//==============================================================================
+Dial::Dial(juce::AudioProcessorValueTreeState& treeState, juce::String parameterId, juce::String parameterName)
+{
+    initLabel(parameterName);
+    addAndMakeVisible(label);
+    
+    initSlider(treeState, parameterId);
+    slider.setLookAndFeel(&dialStyle.get());
+    addAndMakeVisible(slider);
+}
+
+Dial::~Dial()
+{
+    slider.setLookAndFeel(nullptr);
+}
+
+void Dial::initSlider(juce::AudioProcessorValueTreeState& treeState, juce::String parameterId){
+    slider.setSliderStyle(juce::Slider::SliderStyle::Rotary);
+    slider.setTextBoxStyle(juce::Slider::NoTextBox, true, 0, 0);
+    
+    // The look doesn't change on hover, so there's nothing to repaint for
+    slider.setRepaintsOnMouseActivity(false);
+    
+    sliderAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(treeState, parameterId, slider);
+}
+
+void Dial::initLabel(const juce::String parameterName){
+    label.setColour(juce::Label::ColourIds::textColourId, juce::Colours::white);
+    label.setJustificationType(juce::Justification::centred);
+    label.setFont(juce::FontOptions(12.0f));
+    label.setText(parameterName, juce::dontSendNotification);
+}
+
+void Dial::paint (juce::Graphics& g)
+{
+}
+
+void Dial::resized()
+{
+    int labelWidth = getWidth() / 2;
+    int labelHeight = getHeight() * 0.25;
+    int labelX = getWidth() / 2 - labelWidth / 2;
+    int labelY = 0;
+    label.setBounds(labelX, labelY, labelWidth, labelHeight);
+    
+    int sliderWidth, sliderHeight;
+    sliderWidth = sliderHeight = getHeight() * 0.65 * 1.25;
+    int sliderX = getWidth() / 2 - sliderWidth / 2;
+    int sliderY = label.getBottom();
+    
+    slider.setBounds(sliderX, sliderY, sliderWidth, sliderHeight);
+}
+
+bool Dial::hitTest(int x, int y) {
+    bool withinSliderHorizontal = slider.getX() <= x && x <= slider.getRight();
+    bool withinSliderVertical = slider.getY() <= y && y <= slider.getBottom();
+    return withinSliderHorizontal && withinSliderVertical;
+}
+
+//==============================================================================
+void DialLookAndFeel::drawRotarySlider (juce::Graphics& g, int x, int y, int width, int height, float sliderPos, float rotaryStartAngle, float rotaryEndAngle, juce::Slider& slider){
+    
+    int diameter = juce::jmin(width, height) * 0.75;
+    int radius = diameter / 2;
+    int centreX = x + width / 2;
+    int centreY = y + height / 2;
+    float angle = rotaryStartAngle + (sliderPos * (rotaryEndAngle - rotaryStartAngle));
+    
+    // Every dial shares the same angles, but key on them anyway so a dial
+    // that changes its range doesn't pick up another dial's face
+    const juce::int64 angles = ((juce::int64) juce::roundToInt(rotaryStartAngle * 1000.0f) << 32) | (juce::uint32) juce::roundToInt(rotaryEndAngle * 1000.0f);
+    auto face = renderCache->getImage(CachedImage::dialFace, width, height, RenderCache::getScale(g), angles, [&](juce::Graphics& faceGraphics){
+        drawFace(faceGraphics, width, height, rotaryStartAngle, rotaryEndAngle);
+    });
+    g.drawImage(face, juce::Rectangle<int>(x, y, width, height).toFloat());
+    
+    if (radius != tickRadius){
+        float tickWidth = 5.0;
+        float tickHeight = 10.0;
+        juce::Rectangle tick = juce::Rectangle<float>(0.0 - tickWidth / 2, -radius, tickWidth, tickHeight);
+        
+        tickPath.clear();
+        tickPath.addRoundedRectangle(tick, 1.5f);
+        tickRadius = radius;
+    }
+    
+    g.setColour(juce::Colours::white);
+    g.fillPath(tickPath, juce::AffineTransform::rotation(angle).translated(centreX, centreY));
+}
+
+// The parts of the dial that don't move: the knob and the end and centre markers
+void DialLookAndFeel::drawFace (juce::Graphics& g, int width, int height, float rotaryStartAngle, float rotaryEndAngle){
+    
+    int diameter = juce::jmin(width, height) * 0.75;
+    int radius = diameter / 2;
+    int centreX = width / 2;
+    int centreY = height / 2;
+    int rX = centreX - radius;
+    int rY = centreY - radius;
+    
+    g.setColour(juce::Colours::black);
+    g.fillEllipse(rX, rY, diameter, diameter);
+    
+    juce::Path dialEnds;
+    int markRadius = 3;
+    dialEnds.addEllipse(0.0 - markRadius / 2, -radius - 7, markRadius, markRadius);
+    
+    g.setColour(juce::Colours::white);
+    g.fillPath(dialEnds, juce::AffineTransform::rotation(rotaryStartAngle).translated(centreX, centreY));
+    g.fillPath(dialEnds, juce::AffineTransform::rotation(rotaryEndAngle).translated(centreX, centreY));
+    
+    float midAngle = rotaryStartAngle + (0.5 * (rotaryEndAngle - rotaryStartAngle));
+    g.fillPath(dialEnds, juce::AffineTransform::rotation(midAngle).translated(centreX, centreY));
+}
@@ -0,0 +1,137 @@
+/*
+  ==============================================================================
+
+    EchoView.cpp
+    Created: 17 Oct 2026 8:17:52pm
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "EchoView.h"
+
+//==============================================================================
+EchoView::EchoView(SignalFeed& feed, std::atomic<float>* delayParameter) : feed(feed), delayParameter(delayParameter)
+{
+    mipmap.prepare((int) juce::nextPowerOfTwo((int) (ECHO_VIEW_MAX_SECONDS * SUMMARIES_PER_SECOND)));
+    readBuffer.resize(SIGNAL_FEED_CAPACITY);
+    
+    setOpaque(true);
+    
+    feed.setEnabled(true);
+    startTimerHz(ECHO_VIEW_FRAME_RATE);
+}
+
+EchoView::~EchoView()
+{
+    stopTimer();
+    feed.setEnabled(false);
+}
+
+void EchoView::timerCallback()
+{
+    // A new sample rate changes what a summary spans, so the history starts over
+    if (feed.getGeneration() != generation){
+        generation = feed.getGeneration();
+        summaryRate = feed.getSummaryRate();
+        mipmap.clear();
+    }
+    
+    SignalSummary latest;
+    for (int numRead; (numRead = feed.read(readBuffer.data(), (int) readBuffer.size())) > 0;){
+        for (int i = 0; i < numRead; ++i){
+            mipmap.add(readBuffer[(size_t) i]);
+            latest.merge(readBuffer[(size_t) i]);
+        }
+    }
+    
+    const float floorGain = juce::Decibels::decibelsToGain(METER_FLOOR_DB);
+    if (latest.output.numSamples == 0 && outputPeak < floorGain && inputPeak < floorGain){
+        return;
+    }
+    
+    // Meters fall about 60 dB a second instead of dropping straight to silence
+    const float decay = juce::Decibels::decibelsToGain(-60.0f / ECHO_VIEW_FRAME_RATE);
+    inputLevel = juce::jmax(latest.input.getRms(), inputLevel * decay);
+    inputPeak = juce::jmax(latest.input.getPeak(), inputPeak * decay);
+    outputLevel = juce::jmax(latest.output.getRms(), outputLevel * decay);
+    outputPeak = juce::jmax(latest.output.getPeak(), outputPeak * decay);
+    
+    repaint();
+}
+
+void EchoView::paint (juce::Graphics& g)
+{
+    g.fillAll(juce::Colours::darkslateblue.darker(2.0f));
+    
+    auto area = getLocalBounds().reduced(6);
+    auto meterArea = area.removeFromRight(22);
+    area.removeFromRight(6);
+    
+    drawWaveform(g, area);
+    drawMeter(g, meterArea.removeFromLeft(9), inputLevel, inputPeak);
+    meterArea.removeFromLeft(4);
+    drawMeter(g, meterArea.removeFromLeft(9), outputLevel, outputPeak);
+}
+
+void EchoView::drawWaveform(juce::Graphics& g, juce::Rectangle<int> area)
+{
+    const double delaySeconds = 0.001 * delayParameter->load();
+    const double windowSeconds = juce::jlimit(ECHO_VIEW_MIN_SECONDS, ECHO_VIEW_MAX_SECONDS, delaySeconds * ECHO_VIEW_REPEATS);
+    const int width = area.getWidth();
+    if (width <= 0){
+        return;
+    }
+    
+    // A marker for each repeat, counting back from now at the right edge
+    g.setColour(juce::Colours::white.withAlpha(0.15f));
+    for (int repeat = 1; delaySeconds > 0.0 && repeat * delaySeconds < windowSeconds; ++repeat){
+        const int x = area.getRight() - juce::roundToInt(width * repeat * delaySeconds / windowSeconds);
+        g.drawVerticalLine(x, (float) area.getY(), (float) area.getBottom());
+    }
+    
+    const float centreY = (float) area.getCentreY();
+    const float halfHeight = area.getHeight() * 0.5f;
+    auto drawColumn = [&](int x, const LevelSummary& level){
+        const float top = centreY - juce::jlimit(-1.0f, 1.0f, level.maximum) * halfHeight;
+        const float bottom = centreY - juce::jlimit(-1.0f, 1.0f, level.minimum) * halfHeight;
+        g.drawVerticalLine(x, top, juce::jmax(bottom, top + 1.0f));
+    };
+    
+    const juce::int64 end = mipmap.getNumSummaries();
+    const double summariesPerPixel = windowSeconds * summaryRate / width;
+    
+    for (int column = 0; column < width; ++column){
+        const auto start = end - (juce::int64) std::ceil((width - column) * summariesPerPixel);
+        const auto stop = juce::jmax(start + 1, end - (juce::int64) std::ceil((width - column - 1) * summariesPerPixel));
+        const auto summary = mipmap.getRange(start, stop);
+        if (summary.output.numSamples == 0){
+            continue;
+        }
+        
+        // The input behind, faint, and the output with its echoes over it
+        g.setColour(juce::Colours::white.withAlpha(0.3f));
+        drawColumn(area.getX() + column, summary.input);
+        g.setColour(juce::Colours::red.withAlpha(0.85f));
+        drawColumn(area.getX() + column, summary.output);
+    }
+}
+
+void EchoView::drawMeter(juce::Graphics& g, juce::Rectangle<int> area, float level, float peak)
+{
+    auto toProportion = [](float gain){
+        return juce::jmap(juce::Decibels::gainToDecibels(gain, METER_FLOOR_DB), METER_FLOOR_DB, 0.0f, 0.0f, 1.0f);
+    };
+    
+    g.setColour(juce::Colours::black);
+    g.fillRect(area);
+    
+    auto bar = area.toFloat();
+    g.setColour(juce::Colours::red.withAlpha(0.85f));
+    g.fillRect(bar.removeFromBottom(bar.getHeight() * toProportion(level)));
+    
+    const float peakY = area.getBottom() - area.getHeight() * toProportion(peak);
+    g.setColour(juce::Colours::white);
+    g.drawHorizontalLine(juce::roundToInt(peakY), (float) area.getX(), (float) area.getRight());
+}
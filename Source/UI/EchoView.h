@@ -0,0 +1,61 @@
+/*
+  ==============================================================================
+
+    EchoView.h
+    Created: 17 Oct 2026 8:17:52pm
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "SummaryMipmap.h"
+#define ECHO_VIEW_HEIGHT 90
+#define ECHO_VIEW_FRAME_RATE 30
+#define ECHO_VIEW_REPEATS 4
+#define ECHO_VIEW_MIN_SECONDS 0.5
+#define ECHO_VIEW_MAX_SECONDS 60.0
+#define METER_FLOOR_DB -60.0f
+
+//==============================================================================
+/*
+    A scrolling picture of the echo train, with input and output meters.
+
+    The window spans ECHO_VIEW_REPEATS delay times, with a marker at each
+    one. A timer drains the signal feed ECHO_VIEW_FRAME_RATE times a second
+    into a SummaryMipmap, so each pixel column is a few lookups whatever
+    the window length, and only repaints while there is something new.
+    Opening the view just switches the feed on; the audio thread never
+    waits on it.
+*/
+class EchoView  : public juce::Component, private juce::Timer
+{
+public:
+    EchoView(SignalFeed& feed, std::atomic<float>* delayParameter);
+    ~EchoView() override;
+    
+    void paint (juce::Graphics&) override;
+    
+private:
+    SignalFeed& feed;
+    std::atomic<float>* delayParameter = nullptr;
+    
+    SummaryMipmap mipmap;
+    std::vector<SignalSummary> readBuffer;
+    int generation = -1;
+    double summaryRate = SUMMARIES_PER_SECOND;
+    
+    // Meter levels as gains, falling back gradually between frames
+    float inputLevel = 0.0f;
+    float inputPeak = 0.0f;
+    float outputLevel = 0.0f;
+    float outputPeak = 0.0f;
+    
+    void timerCallback() override;
+    void drawWaveform(juce::Graphics& g, juce::Rectangle<int> area);
+    void drawMeter(juce::Graphics& g, juce::Rectangle<int> area, float level, float peak);
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (EchoView)
+};
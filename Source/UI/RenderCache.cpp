@@ -0,0 +1,37 @@
+/*
+  ==============================================================================
+
+    RenderCache.cpp
+    Created: 17 Oct 2026 7:41:18pm
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#include "RenderCache.h"
+
+juce::Image RenderCache::getImage(CachedImage type, int width, int height, float scale, juce::int64 variant,
+                                  const std::function<void(juce::Graphics&)>& draw){
+    const Key key { type, width, height, scale, variant };
+    
+    const auto found = images.find(key);
+    if (found != images.end()){
+        return found->second;
+    }
+    
+    // Resizing an editor walks through many sizes that are never seen
+    // again, so rather than tracking use, start over once the cache is full
+    if (images.size() >= MAX_CACHED_IMAGES){
+        images.clear();
+    }
+    
+    juce::Image image (juce::Image::ARGB, juce::jmax(1, juce::roundToInt(width * scale)), juce::jmax(1, juce::roundToInt(height * scale)), true);
+    {
+        juce::Graphics g (image);
+        g.addTransform(juce::AffineTransform::scale(scale));
+        draw(g);
+    }
+    
+    images.emplace(key, image);
+    return image;
+}
@@ -0,0 +1,58 @@
+/*
+  ==============================================================================
+
+    RenderCache.h
+    Created: 17 Oct 2026 7:41:18pm
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#define MAX_CACHED_IMAGES 64
+
+enum class CachedImage {
+    editorBackground,
+    dialFace,
+    ledGlow
+};
+
+//==============================================================================
+/*
+    Pre-rendered images for the parts of the editor that never change between
+    repaints, shared by every open editor through a
+    juce::SharedResourcePointer. Images are keyed by what they show, their
+    size and the display's pixel scale, plus a variant for anything else
+    they depend on, like a colour. The first paint at a new size draws the
+    image and every later one just blits it.
+
+    Message thread only, like painting itself.
+*/
+class RenderCache {
+public:
+    // Returns the image for the key, calling draw on a miss to render it.
+    // draw paints in component coordinates; the scale is already applied.
+    juce::Image getImage(CachedImage type, int width, int height, float scale, juce::int64 variant,
+                         const std::function<void(juce::Graphics&)>& draw);
+    
+    static float getScale(juce::Graphics& g){
+        return g.getInternalContext().getPhysicalPixelScaleFactor();
+    }
+    
+private:
+    struct Key {
+        CachedImage type;
+        int width;
+        int height;
+        float scale;
+        juce::int64 variant;
+        
+        bool operator<(const Key& other) const {
+            return std::tie(type, width, height, scale, variant) < std::tie(other.type, other.width, other.height, other.scale, other.variant);
+        }
+    };
+    
+    std::map<Key, juce::Image> images;
+};
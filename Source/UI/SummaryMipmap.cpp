@@ -0,0 +1,84 @@
+/*
+  ==============================================================================
+
+    SummaryMipmap.cpp
+    Created: 17 Oct 2026 8:17:52pm
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#include "SummaryMipmap.h"
+
+void SummaryMipmap::prepare(int capacity){
+    jassert(juce::isPowerOfTwo(capacity) && capacity >= (1 << (MIPMAP_LEVELS - 1)));
+    
+    levels.resize(MIPMAP_LEVELS);
+    for (int level = 0; level < MIPMAP_LEVELS; ++level){
+        levels[(size_t) level].assign((size_t) (capacity >> level), SignalSummary());
+    }
+    clear();
+}
+
+void SummaryMipmap::clear(){
+    counts.fill(0);
+}
+
+void SummaryMipmap::add(const SignalSummary& summary){
+    levels[0][(size_t) (counts[0] & (juce::int64) (levels[0].size() - 1))] = summary;
+    ++counts[0];
+    
+    // A new entry completes a pair on the level above every other time
+    for (int level = 1; level < MIPMAP_LEVELS; ++level){
+        const juce::int64 index = counts[(size_t) level];
+        if (counts[(size_t) level - 1] < (index + 1) * 2){
+            break;
+        }
+        
+        SignalSummary merged = getEntry(level - 1, index * 2);
+        merged.merge(getEntry(level - 1, index * 2 + 1));
+        levels[(size_t) level][(size_t) (index & (juce::int64) (levels[(size_t) level].size() - 1))] = merged;
+        ++counts[(size_t) level];
+    }
+}
+
+SignalSummary SummaryMipmap::getRange(juce::int64 start, juce::int64 end) const {
+    SignalSummary result;
+    
+    start = juce::jmax(start, getOldest(0));
+    end = juce::jmin(end, counts[0]);
+    if (start >= end){
+        return result;
+    }
+    
+    // The coarsest level whose entries still fit inside the range
+    int level = 0;
+    while (level + 1 < MIPMAP_LEVELS && ((juce::int64) 2 << level) <= end - start){
+        ++level;
+    }
+    
+    // Whole entries on that level, then the finer levels for the edges. An
+    // entry only counts when it lies entirely inside the range.
+    for (; level >= 0; --level){
+        const juce::int64 size = (juce::int64) 1 << level;
+        juce::int64 first = (start + size - 1) >> level;
+        juce::int64 last = juce::jmin(end >> level, counts[(size_t) level]);
+        first = juce::jmax(first, getOldest(level));
+        
+        if (first >= last){
+            continue;
+        }
+        
+        for (juce::int64 index = first; index < last; ++index){
+            result.merge(getEntry(level, index));
+        }
+        
+        // What's left either side goes to the finer levels
+        if (level > 0){
+            result.merge(getRange(start, first << level));
+            result.merge(getRange(last << level, end));
+        }
+        return result;
+    }
+    return result;
+}
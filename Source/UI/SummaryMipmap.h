@@ -0,0 +1,57 @@
+/*
+  ==============================================================================
+
+    SummaryMipmap.h
+    Created: 17 Oct 2026 8:17:52pm
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "../Processing/SignalFeed.h"
+#define MIPMAP_LEVELS 12
+
+//==============================================================================
+/*
+    A history of signal summaries at several resolutions, for drawing any
+    stretch of it in a few lookups per pixel however long it is.
+
+    Level 0 holds summaries as they arrive and each level above merges pairs
+    from the one below, so level k entry i covers summaries [i * 2^k,
+    (i + 1) * 2^k). Each level is a ring half the size of the one below, so
+    every level reaches equally far back. Adding a summary only merges the
+    pairs it completes, at most one per level.
+
+    Summaries are addressed by how many came before them, counting from the
+    last clear().
+*/
+class SummaryMipmap {
+public:
+    // capacity is the number of summaries kept, a power of two
+    void prepare(int capacity);
+    void clear();
+    
+    void add(const SignalSummary& summary);
+    
+    juce::int64 getNumSummaries() const { return counts[0]; }
+    
+    // Summaries [start, end) merged, from the coarsest level that fits inside
+    // the range. Anything already overwritten is left out.
+    SignalSummary getRange(juce::int64 start, juce::int64 end) const;
+    
+private:
+    std::vector<std::vector<SignalSummary>> levels;
+    std::array<juce::int64, MIPMAP_LEVELS> counts {};
+    
+    const SignalSummary& getEntry(int level, juce::int64 index) const {
+        const auto& entries = levels[(size_t) level];
+        return entries[(size_t) (index & (juce::int64) (entries.size() - 1))];
+    }
+    
+    juce::int64 getOldest(int level) const {
+        return juce::jmax((juce::int64) 0, counts[(size_t) level] - (juce::int64) levels[(size_t) level].size());
+    }
+};
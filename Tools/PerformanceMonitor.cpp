@@ -0,0 +1,286 @@
+/*
+  ==============================================================================
+
+    PerformanceMonitor.cpp
+    Created: 17 Oct 2026 7:02:41pm
+    Author:  Chris
+
+    Live view of every running plugin instance's performance counters, in
+    the style of top. Build it as a JUCE console application containing this
+    file and Source/Diagnostics/PerformanceCounters.h (juce_core and
+    juce_events only - it reads the counters' shared segments and links none
+    of the plugin).
+
+    Usage: PerformanceMonitor [--interval <ms between refreshes, default 1000>]
+                              [--once] [--clean]
+
+    Each process running the plugin publishes a segment in the temporary
+    directory; the monitor maps them read-only, so it can attach and detach
+    at any time without the plugin noticing. Rates are over the last
+    interval, worst cases since the instance was created. --once prints a
+    single refresh without clearing the screen, for logs and scripts, and
+    --clean deletes segments left behind by processes that have crashed.
+
+    Columns:
+      CPU%     share of one core spent in processBlock
+      LOAD%    average block time as a fraction of its real-time budget
+      WORST%   worst block's load, and WORST ms its time
+      XRISK    blocks that used more than XRUN_RISK_LOAD of their budget
+      DENORM   microseconds per second spent entering flush-to-zero mode
+      PARAM/s  parameter changes seen at block starts
+      PAINT    average editor paint time in milliseconds
+      HISTOGRAM  block loads this interval, from under 0.1% up to overruns
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../Source/Diagnostics/PerformanceCounters.h"
+
+#include <map>
+
+namespace {
+
+struct SlotSample {
+    double seconds = 0.0;
+    juce::uint64 numBlocks = 0;
+    juce::uint64 numSamples = 0;
+    juce::uint64 busyNanos = 0;
+    juce::uint64 denormalGuardNanos = 0;
+    juce::uint64 parameterChanges = 0;
+    juce::uint64 numPaints = 0;
+    juce::uint64 paintNanos = 0;
+    juce::uint64 histogram[PERF_HISTOGRAM_BUCKETS] = {};
+};
+
+struct Row {
+    juce::String process;
+    juce::String label;
+    int slot = 0;
+    int sampleRate = 0;
+    int blockSize = 0;
+    int numChannels = 0;
+    bool doublePrecision = false;
+    bool hasRates = false;
+    bool idle = true;
+    double cpuPercent = 0.0;
+    double loadPercent = 0.0;
+    double worstLoadPercent = 0.0;
+    double worstBlockMs = 0.0;
+    juce::uint64 xrunRiskBlocks = 0;
+    double denormalMicrosPerSecond = 0.0;
+    double parameterChangesPerSecond = 0.0;
+    double paintMs = 0.0;
+    std::string histogram;
+};
+
+juce::uint64 load(const std::atomic<juce::uint64>& counter){
+    return counter.load(std::memory_order_relaxed);
+}
+
+SlotSample readSample(const PerformanceSlot& slot, double seconds){
+    SlotSample sample;
+    sample.seconds = seconds;
+    sample.numBlocks = load(slot.numBlocks);
+    sample.numSamples = load(slot.numSamples);
+    sample.busyNanos = load(slot.busyNanos);
+    sample.denormalGuardNanos = load(slot.denormalGuardNanos);
+    sample.parameterChanges = load(slot.parameterChanges);
+    sample.numPaints = load(slot.numPaints);
+    sample.paintNanos = load(slot.paintNanos);
+    for (int bucket = 0; bucket < PERF_HISTOGRAM_BUCKETS; ++bucket){
+        sample.histogram[bucket] = load(slot.histogram[bucket]);
+    }
+    return sample;
+}
+
+// The label is rewritten on the plugin's message thread while we read, so
+// retry until a copy was taken with no write in progress
+juce::String readLabel(const char* source, const std::atomic<juce::uint32>& sequence){
+    char copy[PERF_LABEL_LENGTH];
+    for (int attempt = 0; attempt < 8; ++attempt){
+        const auto before = sequence.load(std::memory_order_acquire);
+        std::memcpy(copy, source, sizeof(copy));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if ((before & 1) == 0 && sequence.load(std::memory_order_relaxed) == before){
+            copy[PERF_LABEL_LENGTH - 1] = 0;
+            return juce::String::fromUTF8(copy);
+        }
+    }
+    return {};
+}
+
+std::string drawHistogram(const juce::uint64* counts){
+    static const char levels[] = " .:-=+*#";
+    const juce::uint64 peak = *std::max_element(counts, counts + PERF_HISTOGRAM_BUCKETS);
+    
+    std::string bars;
+    for (int bucket = 0; bucket < PERF_HISTOGRAM_BUCKETS; ++bucket){
+        // Any count at all shows, however small next to the peak
+        const int level = counts[bucket] == 0 ? 0 : juce::jmax(1, (int) (counts[bucket] * 7 / juce::jmax((juce::uint64) 1, peak)));
+        bars += levels[level];
+    }
+    return bars;
+}
+
+Row makeRow(const PerformanceSlot& slot, const SlotSample& sample, const SlotSample* previous){
+    Row row;
+    row.sampleRate = slot.sampleRate.load(std::memory_order_relaxed);
+    row.blockSize = slot.blockSize.load(std::memory_order_relaxed);
+    row.numChannels = slot.numChannels.load(std::memory_order_relaxed);
+    row.doublePrecision = slot.doublePrecision.load(std::memory_order_relaxed) != 0;
+    row.worstLoadPercent = load(slot.worstLoadPpm) * 1.0e-4;
+    row.worstBlockMs = load(slot.worstBlockNanos) * 1.0e-6;
+    row.xrunRiskBlocks = load(slot.xrunRiskBlocks);
+    row.label = readLabel(slot.label, slot.labelSequence);
+    
+    // A slot seen for the first time, or reused since, has nothing to compare against
+    if (previous == nullptr || previous->numBlocks > sample.numBlocks){
+        row.histogram = drawHistogram(sample.histogram);
+        return row;
+    }
+    
+    const double elapsed = juce::jmax(1.0e-3, sample.seconds - previous->seconds);
+    const double busyNanos = (double) (sample.busyNanos - previous->busyNanos);
+    const double audioNanos = row.sampleRate > 0 ? (double) (sample.numSamples - previous->numSamples) * 1.0e9 / row.sampleRate : 0.0;
+    const auto numPaints = sample.numPaints - previous->numPaints;
+    
+    row.hasRates = true;
+    row.idle = sample.numBlocks == previous->numBlocks;
+    row.cpuPercent = 100.0 * busyNanos / (elapsed * 1.0e9);
+    row.loadPercent = audioNanos > 0.0 ? 100.0 * busyNanos / audioNanos : 0.0;
+    row.denormalMicrosPerSecond = (double) (sample.denormalGuardNanos - previous->denormalGuardNanos) * 1.0e-3 / elapsed;
+    row.parameterChangesPerSecond = (double) (sample.parameterChanges - previous->parameterChanges) / elapsed;
+    row.paintMs = numPaints > 0 ? (double) (sample.paintNanos - previous->paintNanos) * 1.0e-6 / (double) numPaints : 0.0;
+    
+    juce::uint64 counts[PERF_HISTOGRAM_BUCKETS];
+    for (int bucket = 0; bucket < PERF_HISTOGRAM_BUCKETS; ++bucket){
+        counts[bucket] = sample.histogram[bucket] - previous->histogram[bucket];
+    }
+    row.histogram = drawHistogram(counts);
+    return row;
+}
+
+void printRows(std::vector<Row>& rows, int numProcesses, int numStale, bool clearScreen){
+    std::sort(rows.begin(), rows.end(), [](const Row& a, const Row& b){ return a.cpuPercent > b.cpuPercent; });
+    
+    if (clearScreen){
+        std::printf("\x1b[H\x1b[2J");
+    }
+    std::printf("Procrastinator - %s - %d processes, %d instances, %d stale segments\n\n",
+                juce::Time::getCurrentTime().toString(true, true).toRawUTF8(), numProcesses, (int) rows.size(), numStale);
+    std::printf("%-16s %4s %-20s %6s %5s %3s %4s %6s %6s %6s %8s %6s %8s %8s %6s  %s\n",
+                "PROCESS", "SLOT", "LABEL", "RATE", "BLOCK", "CH", "PREC", "CPU%", "LOAD%", "WORST%", "WORST ms",
+                "XRISK", "DENORM", "PARAM/s", "PAINT", "HISTOGRAM");
+    
+    for (const auto& row : rows){
+        std::printf("%-16.16s %4d %-20.20s %6d %5d %3d %4s ", row.process.toRawUTF8(), row.slot,
+                    row.label.isEmpty() ? "-" : row.label.toRawUTF8(), row.sampleRate, row.blockSize, row.numChannels,
+                    row.doublePrecision ? "f64" : "f32");
+        
+        if (!row.hasRates){
+            std::printf("%6s %6s ", "-", "-");
+        }
+        else if (row.idle){
+            std::printf("%6s %6s ", "idle", "-");
+        }
+        else {
+            std::printf("%6.2f %6.1f ", row.cpuPercent, row.loadPercent);
+        }
+        
+        std::printf("%6.1f %8.3f %6llu ", row.worstLoadPercent, row.worstBlockMs, (unsigned long long) row.xrunRiskBlocks);
+        
+        if (row.hasRates){
+            std::printf("%8.1f %8.1f %6.2f", row.denormalMicrosPerSecond, row.parameterChangesPerSecond, row.paintMs);
+        }
+        else {
+            std::printf("%8s %8s %6s", "-", "-", "-");
+        }
+        std::printf("  [%s]\n", row.histogram.c_str());
+    }
+    std::fflush(stdout);
+}
+
+}
+
+int main(int argc, char* argv[]){
+    
+    int intervalMs = 1000;
+    bool once = false;
+    bool clean = false;
+    
+    for (int i = 1; i < argc; ++i){
+        const juce::String argument (argv[i]);
+        const bool hasValue = i + 1 < argc;
+        
+        if (argument == "--interval" && hasValue){
+            intervalMs = juce::jmax(50, juce::String (argv[++i]).getIntValue());
+        }
+        else if (argument == "--once"){
+            once = true;
+        }
+        else if (argument == "--clean"){
+            clean = true;
+        }
+    }
+    
+    // Keyed by segment file and slot, so an instance keeps its history between refreshes
+    std::map<juce::String, SlotSample> previousSamples;
+    
+    for (int refresh = 0;; ++refresh){
+        std::map<juce::String, SlotSample> samples;
+        std::vector<Row> rows;
+        juce::Array<juce::File> staleFiles;
+        int numProcesses = 0;
+        
+        const double seconds = juce::Time::getMillisecondCounterHiRes() * 0.001;
+        
+        for (const auto& file : getPerformanceDirectory().findChildFiles(juce::File::findFiles, false, "*.perf")){
+            juce::MemoryMappedFile mapping (file, juce::MemoryMappedFile::readOnly);
+            const auto* segment = static_cast<const PerformanceSegment*>(mapping.getData());
+            if (segment == nullptr || !segment->isValid(mapping.getSize())){
+                continue;
+            }
+            if (segment->isStale()){
+                staleFiles.add(file);
+                continue;
+            }
+            ++numProcesses;
+            
+            const auto process = juce::String::fromUTF8(segment->processName, (int) strnlen(segment->processName, PERF_LABEL_LENGTH));
+            
+            for (int index = 0; index < PERF_MAX_SLOTS; ++index){
+                const auto& slot = segment->slots[index];
+                if (slot.state.load(std::memory_order_acquire) != (juce::uint32) PerformanceSlotState::live){
+                    continue;
+                }
+                
+                const auto key = file.getFileName() + ":" + juce::String (index);
+                const auto sample = readSample(slot, seconds);
+                const auto previous = previousSamples.find(key);
+                
+                auto row = makeRow(slot, sample, previous != previousSamples.end() ? &previous->second : nullptr);
+                row.process = process.isEmpty() ? file.getFileNameWithoutExtension() : process;
+                row.slot = index;
+                rows.push_back(row);
+                samples[key] = sample;
+            }
+        }
+        
+        if (clean){
+            for (const auto& file : staleFiles){
+                file.deleteFile();
+            }
+        }
+        previousSamples = std::move(samples);
+        
+        // A single refresh waits one interval first, so it has rates to show
+        if (!once || refresh > 0){
+            printRows(rows, numProcesses, staleFiles.size(), !once);
+        }
+        if (once && refresh > 0){
+            return 0;
+        }
+        juce::Thread::sleep(intervalMs);
+    }
+}